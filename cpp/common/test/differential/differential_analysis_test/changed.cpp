@@ -0,0 +1,3 @@
+#include "shared.h"
+
+long double d1; // NON_COMPLIANT - in a changed translation unit
@@ -0,0 +1 @@
+long double d3; // NON_COMPLIANT - included in a changed translation unit
@@ -0,0 +1,4 @@
+#include "shared.h"
+#include "unchanged.h"
+
+long double d2; // COMPLIANT - not in a changed translation unit
@@ -0,0 +1 @@
+long double d4; // COMPLIANT - only included in unchanged translation units
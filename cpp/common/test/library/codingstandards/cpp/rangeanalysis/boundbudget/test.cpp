@@ -0,0 +1,49 @@
+int test_within_budget(int c) {
+  int x1 = c ? 1 : 2; // 2 candidate bounds
+  int x2 = x1 + x1;   // 4 candidate bounds
+  return x2 + x2;     // $ bounds=4..8
+}
+
+int test_conditional_chain(int c) {
+  int x1 = c ? 1 : 2; // 2 candidate bounds
+  int x2 = x1 + x1;   // 4 candidate bounds
+  int x3 = x2 + x2;   // 16 candidate bounds
+  int x4 = x3 + x3;   // $ widened
+  int x5 = x4 + x4;   // $ widened
+  return x5 + 1;      // $ bounds=3..256 widened
+}
+
+int test_phi_chain(int c1, int c2, int c3, int c4, int c5, int c6) {
+  int x = c1 ? 1 : 2; // 2 candidate bounds
+  if (c1) {
+    x = x + 1;
+  } else {
+    x = x * 2;
+  } // 4 candidate bounds
+  if (c2) {
+    x = x + 1;
+  } else {
+    x = x * 2;
+  } // 8 candidate bounds
+  if (c3) {
+    x = x + 1;
+  } else {
+    x = x * 2;
+  } // 16 candidate bounds
+  if (c4) {
+    x = x + 1;
+  } else {
+    x = x * 2;
+  } // 32 candidate bounds
+  if (c5) {
+    x = x + 1;
+  } else {
+    x = x * 2;
+  } // 64 candidate bounds
+  if (c6) {
+    x = x + 1;
+  } else {
+    x = x * 2;
+  }         // 128 candidate bounds, so the phi node is widened
+  return x; // $ bounds=2..255 widened
+}
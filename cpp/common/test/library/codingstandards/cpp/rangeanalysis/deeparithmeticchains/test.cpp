@@ -0,0 +1,233 @@
+// Long chains of dependent arithmetic, as found in unrolled signal processing code. In
+// the default mode the number of candidate bounds of the later expressions grows
+// exponentially with the length of the chain. These functions are used to track the
+// cost of the range analysis when a bound budget is configured.
+
+int benchmark_phi_chain(const int *c) {
+  int x = c[0] ? 1 : 2;
+  if (c[0]) {
+    x = x + 1;
+  } else {
+    x = x * 2;
+  }
+  if (c[1]) {
+    x = x + 2;
+  } else {
+    x = x * 2;
+  }
+  if (c[2]) {
+    x = x + 3;
+  } else {
+    x = x * 2;
+  }
+  if (c[3]) {
+    x = x + 4;
+  } else {
+    x = x * 2;
+  }
+  if (c[4]) {
+    x = x + 5;
+  } else {
+    x = x * 2;
+  }
+  if (c[5]) {
+    x = x + 6;
+  } else {
+    x = x * 2;
+  }
+  if (c[6]) {
+    x = x + 7;
+  } else {
+    x = x * 2;
+  }
+  if (c[7]) {
+    x = x + 8;
+  } else {
+    x = x * 2;
+  }
+  if (c[8]) {
+    x = x + 9;
+  } else {
+    x = x * 2;
+  }
+  if (c[9]) {
+    x = x + 10;
+  } else {
+    x = x * 2;
+  }
+  if (c[10]) {
+    x = x + 11;
+  } else {
+    x = x * 2;
+  }
+  if (c[11]) {
+    x = x + 12;
+  } else {
+    x = x * 2;
+  }
+  if (c[12]) {
+    x = x + 13;
+  } else {
+    x = x * 2;
+  }
+  if (c[13]) {
+    x = x + 14;
+  } else {
+    x = x * 2;
+  }
+  if (c[14]) {
+    x = x + 15;
+  } else {
+    x = x * 2;
+  }
+  if (c[15]) {
+    x = x + 16;
+  } else {
+    x = x * 2;
+  }
+  if (c[16]) {
+    x = x + 17;
+  } else {
+    x = x * 2;
+  }
+  if (c[17]) {
+    x = x + 18;
+  } else {
+    x = x * 2;
+  }
+  if (c[18]) {
+    x = x + 19;
+  } else {
+    x = x * 2;
+  }
+  if (c[19]) {
+    x = x + 20;
+  } else {
+    x = x * 2;
+  }
+  if (c[20]) {
+    x = x + 21;
+  } else {
+    x = x * 2;
+  }
+  if (c[21]) {
+    x = x + 22;
+  } else {
+    x = x * 2;
+  }
+  if (c[22]) {
+    x = x + 23;
+  } else {
+    x = x * 2;
+  }
+  if (c[23]) {
+    x = x + 24;
+  } else {
+    x = x * 2;
+  }
+  return x;
+}
+
+int benchmark_fir(const int *c) {
+  int s0 = c[0] ? 1 : -1;
+  int s1 = c[1] ? 1 : -1;
+  int s2 = c[2] ? 1 : -1;
+  int s3 = c[3] ? 1 : -1;
+  int s4 = c[4] ? 1 : -1;
+  int s5 = c[5] ? 1 : -1;
+  int s6 = c[6] ? 1 : -1;
+  int s7 = c[7] ? 1 : -1;
+  int s8 = c[8] ? 1 : -1;
+  int s9 = c[9] ? 1 : -1;
+  int s10 = c[10] ? 1 : -1;
+  int s11 = c[11] ? 1 : -1;
+  int s12 = c[12] ? 1 : -1;
+  int s13 = c[13] ? 1 : -1;
+  int s14 = c[14] ? 1 : -1;
+  int s15 = c[15] ? 1 : -1;
+  int s16 = c[16] ? 1 : -1;
+  int s17 = c[17] ? 1 : -1;
+  int s18 = c[18] ? 1 : -1;
+  int s19 = c[19] ? 1 : -1;
+  int s20 = c[20] ? 1 : -1;
+  int s21 = c[21] ? 1 : -1;
+  int s22 = c[22] ? 1 : -1;
+  int s23 = c[23] ? 1 : -1;
+  int acc = 0;
+  acc = acc + s0 * 1;
+  acc = acc + s1 * 2;
+  acc = acc + s2 * 3;
+  acc = acc + s3 * 4;
+  acc = acc + s4 * 5;
+  acc = acc + s5 * 6;
+  acc = acc + s6 * 7;
+  acc = acc + s7 * 1;
+  acc = acc + s8 * 2;
+  acc = acc + s9 * 3;
+  acc = acc + s10 * 4;
+  acc = acc + s11 * 5;
+  acc = acc + s12 * 6;
+  acc = acc + s13 * 7;
+  acc = acc + s14 * 1;
+  acc = acc + s15 * 2;
+  acc = acc + s16 * 3;
+  acc = acc + s17 * 4;
+  acc = acc + s18 * 5;
+  acc = acc + s19 * 6;
+  acc = acc + s20 * 7;
+  acc = acc + s21 * 1;
+  acc = acc + s22 * 2;
+  acc = acc + s23 * 3;
+  return acc;
+}
+
+int benchmark_division_chain(const int *c) {
+  int y = c[0] ? 100 : 1000;
+  int s1 = c[1] ? 1 : -1;
+  y = (y + s1) / 2;
+  int s2 = c[2] ? 2 : -2;
+  y = (y + s2) / 2;
+  int s3 = c[3] ? 3 : -3;
+  y = (y + s3) / 2;
+  int s4 = c[4] ? 4 : -4;
+  y = (y + s4) / 2;
+  int s5 = c[5] ? 5 : -5;
+  y = (y + s5) / 2;
+  int s6 = c[6] ? 6 : -6;
+  y = (y + s6) / 2;
+  int s7 = c[7] ? 7 : -7;
+  y = (y + s7) / 2;
+  int s8 = c[8] ? 8 : -8;
+  y = (y + s8) / 2;
+  int s9 = c[9] ? 9 : -9;
+  y = (y + s9) / 2;
+  int s10 = c[10] ? 10 : -10;
+  y = (y + s10) / 2;
+  int s11 = c[11] ? 11 : -11;
+  y = (y + s11) / 2;
+  int s12 = c[12] ? 12 : -12;
+  y = (y + s12) / 2;
+  int s13 = c[13] ? 13 : -13;
+  y = (y + s13) / 2;
+  int s14 = c[14] ? 14 : -14;
+  y = (y + s14) / 2;
+  int s15 = c[15] ? 15 : -15;
+  y = (y + s15) / 2;
+  int s16 = c[16] ? 16 : -16;
+  y = (y + s16) / 2;
+  int s17 = c[17] ? 17 : -17;
+  y = (y + s17) / 2;
+  int s18 = c[18] ? 18 : -18;
+  y = (y + s18) / 2;
+  int s19 = c[19] ? 19 : -19;
+  y = (y + s19) / 2;
+  int s20 = c[20] ? 20 : -20;
+  y = (y + s20) / 2;
+  int s21 = c[21] ? 21 : -21;
+  y = (y + s21) / 2;
+  int s22 = c[22] ? 22 : -22;
+  y = (y + s22) / 2;
+  int s23 = c[23] ? 23 : -23;
+  y = (y + s23) / 2;
+  return y;
+}
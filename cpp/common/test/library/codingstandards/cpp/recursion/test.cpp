@@ -0,0 +1,30 @@
+void leaf() {}
+
+void a();
+void b();
+void c();
+void d();
+void e();
+
+void a() {
+  leaf();
+  b();
+  e();
+}
+
+void b() { a(); }
+
+// Reaches the cycle between `c` and `d`, and is reached from the cycle between
+// `a` and `b`, but is not part of either cycle.
+void e() { c(); }
+
+void c() { d(); }
+
+void d() { c(); }
+
+void self() { self(); }
+
+void caller() {
+  a();
+  self();
+}
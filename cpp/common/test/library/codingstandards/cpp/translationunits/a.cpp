@@ -0,0 +1,4 @@
+#include "common.h"
+#include "h1.h"
+
+int a() { return common() + h1() + h2(); }
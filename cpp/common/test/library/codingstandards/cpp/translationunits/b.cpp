@@ -0,0 +1,4 @@
+#include "common.h"
+#include "shared.h"
+
+int b() { return common() + shared(); }
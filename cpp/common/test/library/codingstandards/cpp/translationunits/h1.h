@@ -0,0 +1,3 @@
+// Only included by a.cpp, so in the same include group as a.cpp.
+#include "h2.h"
+inline int h1() { return 1; }
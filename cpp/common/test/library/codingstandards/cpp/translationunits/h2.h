@@ -0,0 +1,2 @@
+// Only included by h1.h, so in the same include group as a.cpp.
+inline int h2() { return 2; }
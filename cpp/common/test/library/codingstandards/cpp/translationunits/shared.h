@@ -0,0 +1 @@
+inline int shared() { return 3; }
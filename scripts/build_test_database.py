@@ -1,98 +1,218 @@
+import argparse
+from concurrent.futures import ThreadPoolExecutor, as_completed
+import fnmatch
+import hashlib
 import sys
-import shutil 
-import os 
+import shutil
+import os
 import subprocess
-import json 
+import json
 from pathlib import Path
 
-if len(sys.argv) != 4 and len(sys.argv) != 2:
-    print ("Usage: build_test_database.py TEST_FILE | LANGUAGE STANDARD RULE", file=sys.stderr)
-    exit(1)
+help_statement = """
+Build CodeQL databases for the tests of one or more rules.
 
-if len(sys.argv) == 4:
-    LANGUAGE=sys.argv[1]
-    STANDARD=sys.argv[2]
-    RULE=sys.argv[3]
+A database is keyed on a hash of the test sources, the build command and the CodeQL version, and is only
+rebuilt when one of those changes. The databases are created in the 'databases' directory of the current
+working directory, which must be the root of the repository.
 
-if len(sys.argv) == 2:
-    TEST_FILE_PATH=Path(sys.argv[1])
-    if not TEST_FILE_PATH.exists():
-        print(f"The test file {TEST_FILE_PATH} does not exist!", file=sys.stderr)
+Examples:
+  build_test_database.py TEST_FILE
+  build_test_database.py LANGUAGE STANDARD RULE
+  build_test_database.py --all --jobs 8
+  build_test_database.py --all --language c --standard misra --rule 'RULE-1*'
+"""
+
+SOURCE_SUFFIXES = {'.c', '.cpp', '.h', '.hpp', '.hh', '.hxx', '.inc'}
+
+
+def find_rule_for_test_file(test_file_path):
+    """Return the (language, standard, rule) of the test containing the given test file."""
+    if not test_file_path.exists():
+        print(f"The test file {test_file_path} does not exist!", file=sys.stderr)
         exit(1)
-    RULE_PATH=TEST_FILE_PATH.parent
+    rule_path = test_file_path.parent
     while True:
-        if len(list(RULE_PATH.glob("*.expected"))) > 0:
+        if len(list(rule_path.glob("*.expected"))) > 0:
             break
-        if RULE_PATH.parent != RULE_PATH:
-            RULE_PATH = RULE_PATH.parent
+        if rule_path.parent != rule_path:
+            rule_path = rule_path.parent
         else:
-            print(f"The test file {TEST_FILE_PATH} is not a test because we couldn't find an expected file!", file=sys.stderr)
+            print(f"The test file {test_file_path} is not a test because we couldn't find an expected file!", file=sys.stderr)
             exit(1)
-    RULE=RULE_PATH.name
-    TESTS_PATH=RULE_PATH.parent.parent
-    if TESTS_PATH.name != "test":
-        print(f"The test file {TEST_FILE_PATH} is not in the expected test layout, cannot determine standard or language!", file=sys.stderr)
+    tests_path = rule_path.parent.parent
+    if tests_path.name != "test":
+        print(f"The test file {test_file_path} is not in the expected test layout, cannot determine standard or language!", file=sys.stderr)
         exit(1)
 
-    STANDARD_PATH=TESTS_PATH.parent
-    STANDARD=STANDARD_PATH.name
-
-    LANGUAGE_PATH=STANDARD_PATH.parent
-    LANGUAGE=LANGUAGE_PATH.name
-
-if shutil.which("codeql") is None:
-    print ("Please install codeql.", file=sys.stderr)
-    exit(1)
-
-if LANGUAGE == "cpp":
-    compiler = "clang++"
-elif LANGUAGE == "c":
-    compiler = "clang"
-else:
-    exit(f"Unknown language {LANGUAGE}")
-
-if shutil.which(compiler) is None:
-    print (f"Please install {compiler}", file=sys.stderr)
-    exit(1)
-
-
-# check the database directory
-if os.path.exists('databases') and not os.path.isdir('databases'):
-    print ("Please delete the file 'databases' in your home directory before continuing.", file=sys.stderr)
-    exit(1)
-elif not os.path.exists('databases'):
-    print ("Creating database directory in current working directory...")
-    os.mkdir('databases') 
-
-# check the standard
-
-if not os.path.exists(f"{LANGUAGE}/{STANDARD}"):
-    print (f"Standard {STANDARD} doesn't exist.", file=sys.stderr)
-    exit(1)
+    standard_path = tests_path.parent
+    language_path = standard_path.parent
+    return (language_path.name, standard_path.name, rule_path.name)
+
+
+def find_rules(language_filter, standard_filter, rule_filter):
+    """Return the (language, standard, rule) of each rule test directory matching the filters."""
+    rules = []
+    for language in ['c', 'cpp']:
+        if language_filter and language != language_filter:
+            continue
+        for rules_path in sorted(Path(language).glob('*/test/rules')):
+            standard = rules_path.parent.parent.name
+            if standard_filter and standard != standard_filter:
+                continue
+            for rule_path in sorted(rules_path.iterdir()):
+                if not rule_path.is_dir():
+                    continue
+                if rule_filter and not fnmatch.fnmatch(rule_path.name, rule_filter):
+                    continue
+                if len(list(rule_path.glob("*.expected"))) == 0:
+                    continue
+                rules.append((language, standard, rule_path.name))
+    return rules
+
+
+def get_build_command(language, rule_path):
+    """Return the build command for the sources in the rule test directory."""
+    all_files = sorted(os.listdir(rule_path))
+    if language == "cpp":
+        files = ' '.join([f for f in all_files if f.endswith('.cpp')])
+        return f"clang++ -std=c++14 -fsyntax-only {files}"
+    elif language == "c":
+        files = ' '.join([f for f in all_files if f.endswith('.c')])
+        return f"clang -fsyntax-only {files}"
+    else:
+        exit(f"Unknown language {language}")
+
+
+def get_database_key(rule_path, build_command, codeql_version):
+    """Compute a hash of the test sources, the build command and the CodeQL version."""
+    key = hashlib.sha256()
+    key.update(codeql_version.encode('utf-8'))
+    key.update(b'\0')
+    key.update(build_command.encode('utf-8'))
+    for source_path in sorted(rule_path.rglob('*')):
+        if source_path.is_file() and source_path.suffix in SOURCE_SUFFIXES:
+            key.update(b'\0')
+            key.update(str(source_path.relative_to(rule_path)).encode('utf-8'))
+            key.update(b'\0')
+            key.update(source_path.read_bytes())
+    return key.hexdigest()[:16]
+
+
+def build_database(language, standard, rule, codeql_version, databases_path, force):
+    """Build the database for the rule test unless an up-to-date database exists. Returns the database path and whether it was built."""
+    rule_path = Path(language, standard, 'test', 'rules', rule)
+    build_command = get_build_command(language, rule_path)
+    key = get_database_key(rule_path, build_command, codeql_version)
+    database_path = databases_path / f"{rule}@{codeql_version}-{key}"
+
+    # A database is only moved to its final location once it has been successfully finalized
+    if database_path.exists() and not force:
+        return (database_path, False)
+
+    temporary_database_path = databases_path / f".{database_path.name}.tmp"
+    if temporary_database_path.exists():
+        shutil.rmtree(temporary_database_path)
+
+    result = subprocess.run(["codeql", "database", "create", "-l", "cpp", "-s", str(rule_path), f"--command={build_command}", str(temporary_database_path)],
+                            capture_output=True)
+    if result.returncode != 0:
+        shutil.rmtree(temporary_database_path, ignore_errors=True)
+        raise RuntimeError(
+            f"Failed to build database for {language}/{standard}/{rule}:\n{result.stderr.decode('utf-8', errors='replace')}")
+
+    if database_path.exists():
+        shutil.rmtree(database_path)
+    temporary_database_path.rename(database_path)
+    return (database_path, True)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog='build_test_database', description=help_statement, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('test', nargs='*',
+                        help='Either a TEST_FILE, or the LANGUAGE STANDARD RULE of the test to build.')
+    parser.add_argument('--all', action='store_true',
+                        help='Build the databases for all rule tests matching the --language, --standard and --rule filters.')
+    parser.add_argument('--language', choices=['c', 'cpp'],
+                        help='Only build the databases for the given language.')
+    parser.add_argument('--standard', help='Only build the databases for the given standard.')
+    parser.add_argument('--rule', help='Only build the databases for rules matching this glob pattern.')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='The number of databases to build in parallel.')
+    parser.add_argument('--force', action='store_true',
+                        help='Rebuild the databases even if an up-to-date database exists.')
+    args = parser.parse_args()
+
+    if args.all:
+        if len(args.test) != 0:
+            print("Tests cannot be specified together with --all.", file=sys.stderr)
+            exit(1)
+        rules = find_rules(args.language, args.standard, args.rule)
+    elif len(args.test) == 3:
+        rules = [tuple(args.test)]
+    elif len(args.test) == 1:
+        rules = [find_rule_for_test_file(Path(args.test[0]))]
+    else:
+        print("Usage: build_test_database.py TEST_FILE | LANGUAGE STANDARD RULE | --all [--language LANGUAGE] [--standard STANDARD] [--rule RULE_PATTERN]", file=sys.stderr)
+        exit(1)
 
-if not os.path.exists(f"{LANGUAGE}/{STANDARD}/test/rules/{RULE}"):
-    print (f"Rule {RULE} within standard {STANDARD} doesn't exist.", file=sys.stderr)
-    exit(1)
+    if shutil.which("codeql") is None:
+        print("Please install codeql.", file=sys.stderr)
+        exit(1)
 
-# get the codeql version 
-res = subprocess.run(['codeql', 'version', '--format', 'json'], stdout=subprocess.PIPE)
-res_json = json.loads(res.stdout) 
-CODEQL_VERSION=res_json["version"]
+    for compiler in set("clang++" if language == "cpp" else "clang" for language, _, _ in rules):
+        if shutil.which(compiler) is None:
+            print(f"Please install {compiler}", file=sys.stderr)
+            exit(1)
 
-# get the list of cpp files 
-all_files = os.listdir(f"{LANGUAGE}/{STANDARD}/test/rules/{RULE}/")
-# make them into a string argument
+    # check the database directory
+    databases_path = Path('databases')
+    if databases_path.exists() and not databases_path.is_dir():
+        print("Please delete the file 'databases' in your home directory before continuing.", file=sys.stderr)
+        exit(1)
+    elif not databases_path.exists():
+        print("Creating database directory in current working directory...")
+        databases_path.mkdir()
+
+    # check the standard and rules
+    for language, standard, rule in rules:
+        if not os.path.exists(f"{language}/{standard}"):
+            print(f"Standard {standard} doesn't exist.", file=sys.stderr)
+            exit(1)
 
-if LANGUAGE == "cpp":
-    FILES = ' '.join([f for f in all_files if f.endswith('.cpp')])
-    BUILD_COMMAND=f"clang++ -std=c++14 -fsyntax-only {FILES}"
+        if not os.path.exists(f"{language}/{standard}/test/rules/{rule}"):
+            print(f"Rule {rule} within standard {standard} doesn't exist.", file=sys.stderr)
+            exit(1)
 
-elif LANGUAGE == "c":
-    FILES = ' '.join([f for f in all_files if f.endswith('.c')])
-    BUILD_COMMAND=f"clang -fsyntax-only {FILES}"
+    # get the codeql version
+    res = subprocess.run(['codeql', 'version', '--format', 'json'], stdout=subprocess.PIPE)
+    res_json = json.loads(res.stdout)
+    codeql_version = res_json["version"]
+
+    failures = 0
+    built = 0
+    with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as executor:
+        futures = {executor.submit(build_database, language, standard, rule, codeql_version, databases_path, args.force): (language, standard, rule)
+                   for language, standard, rule in rules}
+        for future in as_completed(futures):
+            language, standard, rule = futures[future]
+            try:
+                database_path, was_built = future.result()
+            except RuntimeError as err:
+                failures += 1
+                print(err, file=sys.stderr)
+                continue
+            if was_built:
+                built += 1
+                print(f"Built {database_path}")
+            else:
+                print(f"Reusing up-to-date {database_path}")
+
+    print(f"{built} database(s) built, {len(rules) - built - failures} reused and {failures} failed.")
+    if failures > 0:
+        exit(1)
 
-ITERATION=0
-while os.path.exists(f"databases/{RULE}+{ITERATION}@{CODEQL_VERSION}"):
-    ITERATION = ITERATION + 1 
 
-os.system(f"codeql database create -l cpp -s {LANGUAGE}/{STANDARD}/test/rules/{RULE} --command=\"{BUILD_COMMAND}\" databases/{RULE}+{ITERATION}@{CODEQL_VERSION}")
+if __name__ == '__main__':
+    main()
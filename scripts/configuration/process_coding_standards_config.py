@@ -55,15 +55,23 @@ def is_literal(value):
 def encode_literal(value):
     if isinstance(value, bool):
         return 'true' if value else 'false'
-    return value
+    return str(value)
 
 
-def convert_yaml_file_to_xml(yaml_file):
+def convert_yaml_file_to_xml(yaml_file, extra_data=None):
     with yaml_file.open() as f:
         data = yaml.safe_load(f)
+    if extra_data:
+        data = {**(data or {}), **extra_data}
     convert_yaml_dict_to_xml(data, yaml_file.with_suffix(".xml"))
 
 
+def load_changed_files(changed_files_path):
+    """Read a list of changed files, one per line, as produced by `git diff --name-only`."""
+    with changed_files_path.open() as f:
+        return [line.strip() for line in f if line.strip()]
+
+
 def main():
     parser = argparse.ArgumentParser(
         prog='process_coding_standards_config'
@@ -87,6 +95,12 @@ def main():
         action='store_true',
         help='Skip indexing the configurations and only convert them to XML. Should be used with --save-temps.'
     )
+    parser.add_argument(
+        '--changed-files',
+        help='A file listing the changed files, one per line and relative to the working directory, to which a differential analysis should be restricted. Adds a `differential-analysis` section to the configuration in the working directory.',
+        required=False,
+        type=Path
+    )
     args = parser.parse_args()
 
     if not args.skip_indexing:
@@ -105,10 +119,29 @@ def main():
                 f"The specified working directory '{args.working_dir}'' does not exist.", file=sys.stderr)
             sys.exit(1)
 
+    differential_analysis = None
+    if args.changed_files:
+        if not args.changed_files.exists():
+            print(
+                f"The specified changed files list '{args.changed_files}' does not exist.", file=sys.stderr)
+            sys.exit(1)
+        differential_analysis = {'differential-analysis': {
+            'changed-files': load_changed_files(args.changed_files)}}
+
     # Find all coding standards deviations files, and convert them in place to coding-standards.xml
+    root_config_converted = False
     for config_file_name in ['coding-standards.yml', 'coding-standards.yaml']:
       for path in args.working_dir.rglob(config_file_name):
-        convert_yaml_file_to_xml(path)
+        if differential_analysis and path.parent.resolve() == args.working_dir.resolve() and not root_config_converted:
+          # The changed files are relative to the working directory, so add them to the configuration it contains
+          convert_yaml_file_to_xml(path, differential_analysis)
+          root_config_converted = True
+        else:
+          convert_yaml_file_to_xml(path)
+
+    if differential_analysis and not root_config_converted:
+        convert_yaml_dict_to_xml(
+            differential_analysis, args.working_dir / 'coding-standards.xml')
 
     if not args.skip_indexing:
         # Index the newly generated XML files
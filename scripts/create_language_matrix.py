@@ -1,22 +1,30 @@
+import argparse
 import json
 import os
 from pathlib import Path
 
+parser = argparse.ArgumentParser(
+    prog='create_language_matrix',
+    description='Print the matrix of supported languages and CodeQL environments used by the unit test workflow.')
+parser.add_argument('--shards', type=int, default=1,
+                    help='Split the tests of each language and environment into this many shards, balanced by the timings recorded by scripts/test_sharding/shard_tests.py.')
+args = parser.parse_args()
+
 config_file_path = Path(__file__).parent.parent.joinpath('supported_codeql_configs.json')
 
 with open(config_file_path, "r") as config_file:
     json_data = json.load(config_file)
 
     matrix = []
-    
+
     # foreach language, merge in the existing metadata
     for e in json_data["supported_language"]:
         for c in json_data["supported_environment"]:
             #print(f"lang={e}, env={c}")
-            data = e 
-            data.update(c) 
-            matrix.append(data)
+            for shard in range(1, args.shards + 1):
+                data = dict(e)
+                data.update(c)
+                data.update({"shard": shard, "num_shards": args.shards})
+                matrix.append(data)
 
     print(json.dumps(matrix))
-
-
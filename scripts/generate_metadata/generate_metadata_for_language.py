@@ -1,5 +1,6 @@
 from argparse import ArgumentParser
 from jinja2 import Environment, FileSystemLoader
+import json
 import os
 from pathlib import Path
 
@@ -65,12 +66,26 @@ for package_file in exclusions_path.glob('*.qll'):
     packages.append(package_name)
 
 packages = sorted(packages) 
+
+# Collect the queries which only consider a single translation unit at a time, for which the
+# results can be restricted to the translation units affected by a differential analysis.
+single_translation_unit_queries = []
+for package in packages:
+    with open(rule_package_file_path.joinpath(package + ".json"), "r") as package_file:
+        package_definition = json.load(package_file)
+    for rules in package_definition.values():
+        for rule_details in rules.values():
+            for query in rule_details["queries"]:
+                if "scope/single-translation-unit" in query.get("tags", []):
+                    single_translation_unit_queries.append(
+                        f"{package}Package::{query['short_name'][0].lower()}{query['short_name'][1:]}Query()")
 metadata_template = env.get_template("rulemetadata.qll.template")
 
 print(f"Writing out query help file to {str(metdata_data_file_path)}")
 
 output = metadata_template.render(
-    ql_language=ql_language_name, language_name=language_name, packages=packages)
+    ql_language=ql_language_name, language_name=language_name, packages=packages,
+    single_translation_unit_queries=single_translation_unit_queries)
 
 with open(metdata_data_file_path, "w", newline="\n") as f:
     f.write(output)
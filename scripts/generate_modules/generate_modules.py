@@ -1,52 +1,83 @@
-from bs4 import BeautifulSoup
-import requests
-import re
-from functools import reduce
+"""
+Generate the standard library name tables used by `codingstandards.cpp.Naming` from the results of the queries in
+the `queries` directory, decoded to JSON by the Makefile.
+
+The names are written as rows of `(standard, kind, header, name, qualified name)` to a data extension for the
+`standardLibraryName` extensible predicate, so that adding the names of another standard only adds data, and not QL,
+to the common library.
+"""
 import json
 from pathlib import Path
-from jinja2 import Environment, FileSystemLoader
-from sys import exit
 
 generate_modules_home = Path(__file__).resolve().parent
-common_codingstandards_home = generate_modules_home.parent.parent.joinpath(
-    'cpp', 'common', 'src', 'codingstandards', 'cpp')
-env = Environment(
-    loader=FileSystemLoader(generate_modules_home.joinpath('templates')),
-    trim_blocks=True,
-    lstrip_blocks=True
-)
-
-modules = [
+data_extension_path = generate_modules_home.parent.parent.joinpath(
+    'cpp', 'common', 'src', 'ext', 'stdlib-names.model.yml')
+
+tables = [
+    {
+        "standard": "c++14",
+        "kind": "macro",
+        "file": "cxx14-stdlib-macros.json"
+    },
     {
-        "name": "Naming",
-        "sources": [
-            {
-                "name": "macros",
-                "file": "cxx14-stdlib-macros.json"
-            },
-            {
-                "name": "objects",
-                "file": "cxx14-stdlib-objects.json"
-            },
-            {
-                "name": "functions",
-                "file": "cxx14-stdlib-functions.json"
-            }
-        ]
+        "standard": "c++14",
+        "kind": "object",
+        "file": "cxx14-stdlib-objects.json"
+    },
+    {
+        "standard": "c++14",
+        "kind": "function",
+        "file": "cxx14-stdlib-functions.json"
     }
 ]
 
 
-def load_spec(spec_file):
+def load_tuples(spec_file):
     with spec_file.open() as f:
-        return json.load(f)
+        return json.load(f)["#select"]["tuples"]
+
+
+def get_rows(standard, kind, tuples):
+    """
+    Convert the result tuples of the query for the given kind to rows of the table. The macro query selects the
+    name and header, and the object and function queries select the name, qualified name and header.
+    """
+    rows = []
+    for row in tuples:
+        if kind == "macro":
+            name, header = row
+            qualified_name = name
+        else:
+            name, qualified_name, header = row
+        rows.append((standard, kind, header, name, qualified_name))
+    return rows
+
+
+def write_data_extension(rows, output_path):
+    with output_path.open('w') as f:
+        f.write("# WARNING: This file is auto generated by scripts/generate_modules/generate_modules.py! Do not modify directly!\n")
+        f.write("extensions:\n")
+        f.write("  - addsTo:\n")
+        f.write("      pack: codeql/common-cpp-coding-standards\n")
+        f.write("      extensible: standardLibraryName\n")
+        f.write("    data:\n")
+        for row in rows:
+            # JSON strings are valid YAML double quoted scalars
+            f.write(f"      - [{', '.join(json.dumps(value) for value in row)}]\n")
+
+
+def main():
+    rows = []
+    for table in tables:
+        print(f"Loading the {table['standard']} {table['kind']} names")
+        tuples = load_tuples(generate_modules_home.joinpath(table["file"]))
+        rows.extend(get_rows(table["standard"], table["kind"], tuples))
+    # Declarations in multiple headers, or overloads, result in duplicate rows
+    rows = sorted(set(rows))
+    print(f"Writing {len(rows)} names to {data_extension_path}")
+    write_data_extension(rows, data_extension_path)
+    print("Done")
 
 
-for module in modules:
-    print(f"Generating module {module['name']}")
-    sources = {source["name"]: load_spec(generate_modules_home.joinpath(source["file"]))[
-        "#select"]["tuples"] for source in module['sources']}
-    template = env.get_template(f"{module['name']}.qll.template")
-    template.stream(sources).dump(
-        str(common_codingstandards_home.joinpath(f"{module['name']}.qll")))
-print("Done")
+if __name__ == '__main__':
+    main()
@@ -52,6 +52,19 @@ All Parameters:
         Accept pipeline input?       false
         Accept wildcard characters?  false
 
+    -DatabaseCacheDirectory <String>
+        Build each test database once per test directory, compiler
+        configuration and compiler flags, and store it in this directory under
+        a key derived from the contents of the test directory. All the queries
+        that share a test directory, and later runs against unchanged test
+        directories, reuse the cached database instead of extracting a new one.
+
+        Required?                    false
+        Position?                    named
+        Default value
+        Accept pipeline input?       false
+        Accept wildcard characters?  false
+
     -Configuration <String>
         The compiler to use.
 
@@ -135,6 +148,11 @@ param(
     [switch]
     $UseTmpDir,
 
+    # Build each test database once and reuse it from this cache directory.
+    [Parameter(Mandatory = $false)] 
+    [string]
+    $DatabaseCacheDirectory,
+
     # Number of threads to use
     [Parameter(Mandatory = $false)] 
     [string]
@@ -215,6 +233,12 @@ Import-Module -Name "$PSScriptRoot/../PSCodingStandards/CodingStandards"
 . "$PSScriptRoot/Config.ps1"
 
 $REPORT = @() 
+
+if ($DatabaseCacheDirectory) {
+    # The parallel jobs below may not share our working directory.
+    $DatabaseCacheDirectory = $ExecutionContext.SessionState.Path.GetUnresolvedProviderPathFromPSPath($DatabaseCacheDirectory)
+    Write-Host "Using database cache $DatabaseCacheDirectory"
+}
 $queriesToCheck = @()
 
 #
@@ -281,6 +305,7 @@ $jobRows = $queriesToCheck | ForEach-Object -ThrottleLimit $NumThreads -Parallel
     Import-Module -Name "$using:PSScriptRoot/../PSCodingStandards/CodingStandards"
 
     . "$using:PSScriptRoot/NewDatabaseForRule.ps1"
+    . "$using:PSScriptRoot/Get-CachedDatabaseForRule.ps1"
     . "$using:PSScriptRoot/ExecuteQueryAndDecodeAsJson.ps1"
     . "$using:PSScriptRoot/Get-CompilerSpecificFiles.ps1"
     . "$using:PSScriptRoot/Pop-CompilerSpecificFiles.ps1"
@@ -341,7 +366,12 @@ $jobRows = $queriesToCheck | ForEach-Object -ThrottleLimit $NumThreads -Parallel
             Write-Host "Compiling database in $testDirectory..." -NoNewline
 
             try {
-                $db = New-Database-For-Rule -RuleName $CurrentRuleName -RuleTestDir $testDirectory -Configuration $using:Configuration -Language $using:Language
+                if ($using:DatabaseCacheDirectory) {
+                    $db = Get-CachedDatabaseForRule -RuleName $CurrentRuleName -RuleTestDir $testDirectory -Configuration $using:Configuration -Language $using:Language -CodeQLVersion $using:CODEQL_VERSION -CacheDirectory $using:DatabaseCacheDirectory
+                }
+                else {
+                    $db = New-Database-For-Rule -RuleName $CurrentRuleName -RuleTestDir $testDirectory -Configuration $using:Configuration -Language $using:Language
+                }
                 Write-Host -ForegroundColor ([ConsoleColor]2) "OK" 
             }
             catch {
@@ -0,0 +1,56 @@
+. "$PSScriptRoot/NewDatabaseForRule.ps1"
+. "$PSScriptRoot/Get-DatabaseCacheKey.ps1"
+function Get-CachedDatabaseForRule {
+    param([Parameter(Mandatory)]
+        [string]
+        $RuleName,
+        [Parameter(Mandatory)]
+        [string]
+        $RuleTestDir,
+        [Parameter(Mandatory)]
+        [string]
+        $Configuration,
+        [Parameter(Mandatory)]
+        [ValidateSet('c', 'cpp')]
+        [string]
+        $Language,
+        [Parameter(Mandatory)]
+        [string]
+        $CodeQLVersion,
+        [Parameter(Mandatory)]
+        [string]
+        $CacheDirectory
+    )
+
+    # Databases are stored in the cache under their content-addressed key, so
+    # all the queries which share a test directory, and all the runs with the
+    # same compiler configuration, reuse a single database.
+    $key = Get-DatabaseCacheKey -TestDirectory $RuleTestDir -Configuration $Configuration -Language $Language -CodeQLVersion $CodeQLVersion
+    $DB_PATH = Join-Path $CacheDirectory "$key.testproj"
+
+    if (Test-Path (Join-Path $DB_PATH "codeql-database.yml")) {
+        Write-Host "Reusing cached database $DB_PATH for $RuleTestDir"
+        return $DB_PATH
+    }
+
+    # Only move the database into the cache once it has been created
+    # completely, so that a failed or interrupted build is never reused.
+    New-Item -Path $CacheDirectory -ItemType Directory -ErrorAction Ignore | Out-Null
+    $pending = Join-Path $CacheDirectory "$key.$([System.Guid]::NewGuid()).tmp"
+
+    try {
+        New-Database-For-Rule -RuleName $RuleName -RuleTestDir $RuleTestDir -Configuration $Configuration -Language $Language -DatabasePath $pending | Out-Null
+        if (Test-Path (Join-Path $DB_PATH "codeql-database.yml")) {
+            # Another run has populated the cache in the meantime.
+            Remove-Item -Path $pending -Recurse -Force
+        }
+        else {
+            Move-Item -Path $pending -Destination $DB_PATH
+        }
+    }
+    finally {
+        Remove-Item -Path $pending -Recurse -Force -ErrorAction Ignore
+    }
+
+    return $DB_PATH
+}
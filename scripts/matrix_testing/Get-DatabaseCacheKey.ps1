@@ -0,0 +1,53 @@
+. "$PSScriptRoot/Get-CompilerExecutable.ps1"
+. "$PSScriptRoot/Get-CompilerArgs.ps1"
+function Get-DatabaseCacheKey {
+    param([Parameter(Mandatory)]
+        [string]
+        $TestDirectory,
+        [Parameter(Mandatory)]
+        [string]
+        $Configuration,
+        [Parameter(Mandatory)]
+        [ValidateSet('c', 'cpp')]
+        [string]
+        $Language,
+        [Parameter(Mandatory)]
+        [string]
+        $CodeQLVersion
+    )
+    #
+    # The key identifies a database by everything that goes into building it:
+    # the CodeQL version, the test directory, the compiler and its flags
+    # (including any `options.<configuration>` file), and the contents of the
+    # files in the test directory. It must be computed after the compiler
+    # specific files have been pushed, so that the generic files hold the
+    # contents that will actually be compiled.
+    #
+    # Files outside of the test directory, such as system headers, are not
+    # part of the key.
+    #
+    $CompilerExecutable = Get-CompilerExecutable -Configuration $Configuration -Language $Language
+    $CompilerArgs = Get-CompilerArgs -Configuration $Configuration -Language $Language -TestDirectory $TestDirectory
+
+    $testDirectoryPath = (Resolve-Path $TestDirectory).Path
+    $keyLines = [System.Collections.Generic.List[string]]::new()
+    $keyLines.Add("codeql=$CodeQLVersion")
+    $keyLines.Add("language=$Language")
+    $keyLines.Add("directory=$([IO.Path]::GetRelativePath((Get-RepositoryRoot), $testDirectoryPath).Replace([IO.Path]::DirectorySeparatorChar, "/"))")
+    $keyLines.Add("command=$CompilerExecutable $CompilerArgs")
+
+    # Databases and test outputs in the test directory do not affect the database.
+    $sourceFiles = Get-ChildItem -Path $testDirectoryPath -File -Recurse |
+        Where-Object { $_.FullName -notmatch '\.testproj([\\/]|$)' } |
+        Where-Object { $_.Extension -notin @(".expected", ".actual", ".ql", ".qlref") -and $_.Name -notmatch '\.expected\.' } |
+        Sort-Object -Property FullName
+
+    foreach ($f in $sourceFiles) {
+        $relativePath = $f.FullName.Substring($testDirectoryPath.Length).Replace([IO.Path]::DirectorySeparatorChar, "/")
+        $keyLines.Add("$relativePath=$((Get-FileHash -Algorithm SHA256 -Path $f.FullName).Hash)")
+    }
+
+    $keyBytes = [System.Text.Encoding]::UTF8.GetBytes([String]::Join("`n", $keyLines))
+    $hash = [System.Security.Cryptography.SHA256]::Create().ComputeHash($keyBytes)
+    return ([System.BitConverter]::ToString($hash) -replace '-', '').ToLower()
+}
@@ -16,7 +16,12 @@ function New-Database-For-Rule {
         [Parameter(Mandatory)] 
         [ValidateSet('c', 'cpp')]
         [string]
-        $Language
+        $Language,
+        # The path to create the database at. By default, a new database name
+        # is generated.
+        [Parameter(Mandatory = $false)]
+        [string]
+        $DatabasePath
     )
 
     Write-Host "Creating Database for Rule $RuleName..."
@@ -29,7 +34,10 @@ function New-Database-For-Rule {
     $CompilerArgs = Get-CompilerArgs -Configuration $Configuration -Language $Language -TestDirectory $RuleTestDir
     $BUILD_COMMAND = "$CompilerExecutable $CompilerArgs $cppFilesString"
 
-    if ($UseTmpDir) {
+    if ($DatabasePath) {
+        $DB_PATH = $DatabasePath
+    }
+    elseif ($UseTmpDir) {
         $DB_PATH = Get-New-DB-Name
     }
     else {
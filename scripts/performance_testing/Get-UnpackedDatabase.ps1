@@ -0,0 +1,43 @@
+function Get-UnpackedDatabase {
+    param(
+        [Parameter(Mandatory)]
+        [string]
+        $DatabaseArchive,
+
+        [Parameter(Mandatory)]
+        [string]
+        $CacheDirectory
+    )
+
+    # Databases are unpacked once per archive, keyed on the name, size and
+    # modification time of the archive, and reused by later runs.
+    $archive = Get-Item $DatabaseArchive
+    $database = Join-Path $CacheDirectory "$($archive.BaseName)-$($archive.Length)-$($archive.LastWriteTimeUtc.Ticks)"
+
+    if (Test-Path (Join-Path $database "codeql-database.yml")) {
+        Write-Host "Reusing unpacked database $database"
+        return $database
+    }
+
+    Write-Host "Unpacking database to $database..."
+    $unpacked = "$database.tmp"
+    Remove-Item -Path $unpacked -Recurse -Force -ErrorAction Ignore
+    New-Item -Path $CacheDirectory -ItemType Directory -ErrorAction Ignore | Out-Null
+    Expand-Archive -LiteralPath $archive.FullName -DestinationPath $unpacked
+
+    # The archive may contain the database directory, or the contents of the
+    # database directory.
+    $databaseRoot = (Get-ChildItem -Path $unpacked -Filter "codeql-database.yml" -Recurse | Select-Object -First 1).Directory
+    if ($null -eq $databaseRoot) {
+        Remove-Item -Path $unpacked -Recurse -Force
+        throw "The archive $DatabaseArchive does not contain a CodeQL database."
+    }
+
+    # Only move the database to its final location once it has been unpacked
+    # completely, so that an interrupted unpack is never reused.
+    Remove-Item -Path $database -Recurse -Force -ErrorAction Ignore
+    Move-Item -Path $databaseRoot.FullName -Destination $database
+    Remove-Item -Path $unpacked -Recurse -Force -ErrorAction Ignore
+
+    return $database
+}
@@ -1,13 +1,14 @@
 <#
 .SYNOPSIS
-    Test release performance. Generates outputs 2 csv files containing the slowest predicates as well as the queries
-    causing work. Note that the method of computing query execution time is inaccurate due to the shared nature of 
-    predicates. 
+    Test release performance. Generates csv files containing the run time of each query, and the run time, tuple
+    counts and RA pipeline sizes of each predicate, read from the structured evaluator log of each run.
 
 .DESCRIPTION
-    Test release performance. Generates outputs 2 csv files containing the slowest predicates as well as the queries
-    causing work. Note that the method of computing query execution time is inaccurate due to the shared nature of 
-    predicates. 
+    Test release performance. Generates csv files containing the run time of each query, and the run time, tuple
+    counts and RA pipeline sizes of each predicate, read from the structured evaluator log of each run. The suite may
+    be run repeatedly, both with a cleared evaluation cache (cold) and with the cache of the previous run (warm), so
+    that the variation between runs can be measured. Note that the time of a query only includes the predicates that
+    were computed on its behalf, see profile_predicates.py for an attribution of the time of shared predicates.
 #>
 param(
     # Configures tool to run tests. 
@@ -21,11 +22,33 @@ param(
     $Threads=5,
 
     # Specifies the database to use for testing. Should be a zipped database 
-    # directory. 
-    [Parameter(Mandatory, ParameterSetName = 'RunTests')] 
+    # directory. The archive is unpacked once into -DatabaseCacheDirectory, and
+    # reused by later runs.
+    [Parameter(Mandatory=$false, ParameterSetName = 'RunTests')] 
     [string]
     $DatabaseArchive,
 
+    # Specifies an unpacked database to use for testing, instead of 
+    # -DatabaseArchive.
+    [Parameter(Mandatory=$false, ParameterSetName = 'RunTests')] 
+    [string]
+    $DatabaseDirectory,
+
+    # The directory in which database archives are unpacked.
+    [Parameter(Mandatory=$false, ParameterSetName = 'RunTests')] 
+    [string]
+    $DatabaseCacheDirectory=(Join-Path ([System.IO.Path]::GetTempPath()) "coding-standards-performance-databases"),
+
+    # The number of runs with a cleared evaluation cache.
+    [Parameter(Mandatory=$false, ParameterSetName = 'RunTests')] 
+    [int]
+    $ColdRepetitions=1,
+
+    # The number of runs reusing the evaluation cache of the previous run.
+    [Parameter(Mandatory=$false, ParameterSetName = 'RunTests')] 
+    [int]
+    $WarmRepetitions=0,
+
     # The timestamp to use for the test.
     [Parameter(Mandatory = $false, ParameterSetName = 'RunTests')] 
     [string]
@@ -41,7 +64,8 @@ param(
     [switch]
     $ProcessResults,
 
-    # Configures tool to process results.
+    # Configures tool to process results. The evaluator log written by 
+    # `codeql database analyze --evaluator-log`.
     [Parameter(Mandatory, ParameterSetName = 'ProcessResults')] 
     [string]
     $ResultsFile,
@@ -74,9 +98,7 @@ Import-Module -Name "$PSScriptRoot/../PSCodingStandards/CodingStandards"
 
 . "$PSScriptRoot/Config.ps1"
 . "$PSScriptRoot/Get-TestTmpDirectory.ps1"
-. "$PSScriptRoot/Convert-DurationStringToMs.ps1"
-. "$PSScriptRoot/Get-DurationString.ps1"
-. "$PSScriptRoot/Get-QueryString.ps1"
+. "$PSScriptRoot/Get-UnpackedDatabase.ps1"
 
 # Test Programs 
 Write-Host "Checking 'codeql' program...." -NoNewline
@@ -91,7 +113,10 @@ if (-Not ($CODEQL_VERSION -eq $REQUIRED_CODEQL_VERSION)) {
 }
 Write-Host -ForegroundColor ([ConsoleColor]2) "OK"
 
-
+$PYTHON = if (Get-Command "python3" -ErrorAction SilentlyContinue) { "python3" } else { "python" }
+Write-Host "Checking '$PYTHON' program...." -NoNewline
+Test-ProgramInstalled -Program $PYTHON
+Write-Host -ForegroundColor ([ConsoleColor]2) "OK" 
 
 # Create the results/work directory 
 $RESULTS_DIRECTORY = Get-TestTmpDirectory 
@@ -99,115 +124,128 @@ New-Item -Path $RESULTS_DIRECTORY -ItemType Directory | Out-Null
 
 Write-Host "Writing Results to $RESULTS_DIRECTORY"
 
-if (-Not $ProcessResults){
+# We root this in $ResultsDirectory/release-$Release-<date_of_run>/platform-<platform_name>/language-<language>
+$outputDirectory = (Join-Path $ResultsDirectory "release=$ReleaseTag,testedOn=$TestTimestamp" "platform=$Platform" "language=$Language")
+New-Item -Type Directory -Path $outputDirectory -ErrorAction Ignore | Out-Null
 
-    $DB_UNPACKED_TMP = Join-Path $RESULTS_DIRECTORY db-unpacked
-    $DB_UNPACKED     = Join-Path $RESULTS_DIRECTORY db
-    $DB_FILENAME     = (Get-Item $DatabaseArchive).Name
-    Write-Host "Copying database to $RESULTS_DIRECTORY..."
-    # Copy and unpack the dataset 
-    Copy-Item -Path $DatabaseArchive -Destination $RESULTS_DIRECTORY
+function Write-RunResults {
+    param(
+        [Parameter(Mandatory)] 
+        [string]
+        $EvaluatorLog,
+
+        [Parameter(Mandatory)] 
+        [string]
+        $RunName
+    )
+
+    # Summarize the structured evaluator log, instead of parsing the progress 
+    # messages of the run.
+    $evaluatorLogSummary = Join-Path $RESULTS_DIRECTORY "$RunName-evaluator-log-summary.json"
+    $procDetails = Start-Process -FilePath "codeql" -PassThru -NoNewWindow -Wait -ArgumentList "generate log-summary $EvaluatorLog $evaluatorLogSummary"
+    if (-Not ($procDetails.ExitCode -eq 0)) {
+        Write-Host -ForegroundColor ([ConsoleColor]4) "FAILED" 
+        throw "Did not find performance results summary."
+    }
 
-    Expand-Archive -LiteralPath $RESULTS_DIRECTORY\$DB_FILENAME -DestinationPath $DB_UNPACKED_TMP 
+    $filePrefix = "suite=$Suite,$RunName"
+    $queryOutputFile = Join-Path $outputDirectory "$filePrefix,datum=queries.csv"
+    $predicateOutputFile = Join-Path $outputDirectory "$filePrefix,datum=predicates.csv"
 
-    foreach($f in Get-ChildItem $DB_UNPACKED_TMP){
-        Move-Item -Path $f -Destination $DB_UNPACKED 
+    Write-Host "Writing report to $queryOutputFile"
+    & $PYTHON (Join-Path $PSScriptRoot "summarize_evaluator_log.py") $evaluatorLogSummary --queries-csv $queryOutputFile --predicates-csv $predicateOutputFile
+    if (-Not ($LASTEXITCODE -eq 0)) {
+        throw "Failed to summarize the evaluator log $EvaluatorLog."
     }
 
+    Copy-Item -Path $evaluatorLogSummary -Destination (Join-Path $outputDirectory "$filePrefix,datum=evaluator-log.json")
+}
 
-    $SARIF_OUT = Join-Path $RESULTS_DIRECTORY "suite=$Suite,datum=sarif.sarif"
-    $EvaluatorLog = Join-Path $RESULTS_DIRECTORY "evaluator-log.json"
-    $EvaluatorResults = Join-Path $RESULTS_DIRECTORY "evaluator-results.json"
+if ($ProcessResults) {
+    Write-RunResults -EvaluatorLog $ResultsFile -RunName "mode=cold,run=1"
+    return
+}
 
+if ($DatabaseDirectory) {
+    $DB_UNPACKED = $DatabaseDirectory
+}
+elseif ($DatabaseArchive) {
+    $DB_UNPACKED = Get-UnpackedDatabase -DatabaseArchive $DatabaseArchive -CacheDirectory $DatabaseCacheDirectory
+}
+else {
+    throw "Either -DatabaseArchive or -DatabaseDirectory must be specified."
+}
 
-    $stdOut = Join-Path ([System.IO.Path]::GetTempPath()) ([System.Guid]::NewGuid())
-    $stdErr = Join-Path ([System.IO.Path]::GetTempPath()) ([System.Guid]::NewGuid())
-        
-    Write-Host "Standard Out Buffered to: $stdOut"
-    Write-Host "Standard Error Buffered to: $stdErr"
+if ($ColdRepetitions + $WarmRepetitions -lt 1) {
+    throw "At least one cold or warm repetition must be run."
+}
 
-    $SuiteRoot = Join-Path $Language $Suite "src" "codeql-suites"
-    # For some reason nothing is written to stdout so we use stderr 
-    $SuitePath = Join-Path $CodingStandardsPath $SuiteRoot ($Suite + "-default.qls")
-    $procDetails = Start-Process -FilePath "codeql" -PassThru -NoNewWindow -Wait -ArgumentList "database analyze --rerun --threads $Threads --debug --tuple-counting  --evaluator-log=$EvaluatorLog --format sarif-latest --search-path $(Resolve-Path $CodingStandardsPath) --output $SARIF_OUT $DB_UNPACKED $SuitePath" -RedirectStandardOutput $stdOut -RedirectStandardError $stdErr
+$SuiteRoot = Join-Path $Language $Suite "src" "codeql-suites"
+$SuitePath = Join-Path $CodingStandardsPath $SuiteRoot ($Suite + "-default.qls")
 
-    if (-Not $procDetails.ExitCode -eq 0) {
-        Get-Content $stdErr | Out-String | Write-Host 
-        Write-Host -ForegroundColor ([ConsoleColor]4) "FAILED" 
-        throw "Performance suite failed to run. Will not report data."
-    }
-    else {
-        Write-Host -ForegroundColor ([ConsoleColor]2) "OK" 
-        $runData = $stdErr
-    }
+function Invoke-Suite {
+    param(
+        [Parameter(Mandatory)] 
+        [string]
+        $RunName,
 
-}else{
-    $runData = $ResultsFile
-}
-# Step 1: Compile data from queries
-# 
-$PERFORMANCE_DATA = @()
+        [Parameter(Mandatory)] 
+        [string]
+        $SarifOut,
 
-foreach($l in Get-Content $runData){
+        [Parameter(Mandatory)] 
+        [string]
+        $EvaluatorLog
+    )
 
-    # skip lines that aren't ones we can process
-    if(-Not $l.Contains("Evaluation done;")){
-        continue 
-    }
+    $stdOut = Join-Path $RESULTS_DIRECTORY "$RunName-stdout.txt"
+    $stdErr = Join-Path $RESULTS_DIRECTORY "$RunName-stderr.txt"
 
-    $durationString = Get-DurationString -LogLine $l 
-    $queryString    = Get-QueryString -LogLine $l 
-    $timeInMs       = Convert-DurationStringToMs -DurationString $durationString 
+    Write-Host "Running $Suite suite ($RunName)...." -NoNewline
+    $procDetails = Start-Process -FilePath "codeql" -PassThru -NoNewWindow -Wait -ArgumentList "database analyze --rerun --threads $Threads --tuple-counting --evaluator-log=$EvaluatorLog --format sarif-latest --search-path $(Resolve-Path $CodingStandardsPath) --output $SarifOut $DB_UNPACKED $SuitePath" -RedirectStandardOutput $stdOut -RedirectStandardError $stdErr
 
-    $row = @{
-        "Query"           = $queryString;
-        "TimeInMs"         = $timeInMs;
+    if (-Not ($procDetails.ExitCode -eq 0)) {
+        Get-Content $stdErr | Out-String | Write-Host 
+        Write-Host -ForegroundColor ([ConsoleColor]4) "FAILED" 
+        throw "Performance suite failed to run. Will not report data."
     }
-
-    Write-Host "LOG: Duration=$durationString; TimeInMs=$timeInMs; Query=$queryString"
-
-    $PERFORMANCE_DATA += $row 
+    Write-Host -ForegroundColor ([ConsoleColor]2) "OK" 
 }
-# Step 2: Compile predicate data 
-#
-#
-
-# the data must first be transformed 
-$procDetails = Start-Process -FilePath "codeql" -PassThru -NoNewWindow -Wait -ArgumentList "generate log-summary $EvaluatorLog  $EvaluatorResults"
 
-if (-Not $procDetails.ExitCode -eq 0) {
-    Write-Host -ForegroundColor ([ConsoleColor]4) "FAILED" 
-    throw "Did not find performance results summary."
+# Cold runs come first, so that the last of them populates the evaluation
+# cache for the warm runs.
+$runs = [System.Collections.Generic.List[object]]::new()
+for ($i = 1; $i -le $ColdRepetitions; $i++) {
+    $runs.Add(@{ Mode = "cold"; Run = $i })
 }
-else {
-    Write-Host -ForegroundColor ([ConsoleColor]2) "OK" 
+for ($i = 1; $i -le $WarmRepetitions; $i++) {
+    $runs.Add(@{ Mode = "warm"; Run = $i })
 }
 
+if ($ColdRepetitions -eq 0) {
+    # Populate the evaluation cache, without recording the run, so that the
+    # first warm run is measured against the same cache as the following ones.
+    Invoke-Suite -RunName "mode=prime" -SarifOut (Join-Path $RESULTS_DIRECTORY "prime.sarif") -EvaluatorLog (Join-Path $RESULTS_DIRECTORY "prime-evaluator-log.json")
+}
 
-# Step 3: Write out granular performance data
-# 
-# We root this in $ResultsDirectory/release-$Release-<date_of_run>/platform-<platform_name>/$Suite.csv
-
-# Create the Directory (and it's parents)
-$outputDirectory = (Join-Path $ResultsDirectory "release=$ReleaseTag,testedOn=$TestTimestamp" "platform=$Platform" "language=$Language")
-$outputDirectorySARIF = $outputDirectory
-
-$queryOutputFile = Join-Path $outputDirectory "suite=$Suite,datum=queries.csv"
-$evaluatorResultsFile = Join-Path $outputDirectory "suite=$Suite,datum=evaluator-log.json"
-
-# Create the output directory.
-# note there is no need to create the sarif out directory -- it will be created
-# by the copy command, below.
-
-New-Item -Type Directory -Path $outputDirectory -ErrorAction Ignore | Out-Null
+foreach ($run in $runs) {
+    $runName = "mode=$($run.Mode),run=$($run.Run)"
 
+    if ($run.Mode -eq "cold") {
+        $procDetails = Start-Process -FilePath "codeql" -PassThru -NoNewWindow -Wait -ArgumentList "database cleanup --cache-cleanup=clear $DB_UNPACKED"
+        if (-Not ($procDetails.ExitCode -eq 0)) {
+            throw "Failed to clear the evaluation cache of $DB_UNPACKED."
+        }
+    }
 
-# Copy processed results out
-Copy-Item -Path $EvaluatorResults -Destination $evaluatorResultsFile
-Copy-Item -Path $SARIF_OUT -Destination $outputDirectorySARIF
+    $sarifOut = Join-Path $RESULTS_DIRECTORY "$runName.sarif"
+    $evaluatorLog = Join-Path $RESULTS_DIRECTORY "$runName-evaluator-log.json"
+    Invoke-Suite -RunName $runName -SarifOut $sarifOut -EvaluatorLog $evaluatorLog
+    Write-RunResults -EvaluatorLog $evaluatorLog -RunName $runName
 
-# Write out the report 
-Write-Host "Writing report to $queryOutputFile"
-foreach ($r in $PERFORMANCE_DATA) {
-    [PSCustomObject]$r | Export-CSV -Path $queryOutputFile -Append -NoTypeInformation
-}
\ No newline at end of file
+    # The results of each run are the same, so only keep those of the first.
+    $sarifOutputFile = Join-Path $outputDirectory "suite=$Suite,datum=sarif.sarif"
+    if (-Not (Test-Path $sarifOutputFile)) {
+        Copy-Item -Path $sarifOut -Destination $sarifOutputFile
+    }
+}
@@ -0,0 +1,211 @@
+import argparse
+import io
+from collections import defaultdict
+from pathlib import Path
+import re
+import statistics
+import sys
+import evaluator_log
+from evaluator_log import iter_evaluator_log_events, is_computed_predicate_event, attribute_query_costs
+
+help_statement = """
+Compare the performance of a candidate release against a baseline release, using the evaluator log summaries
+(`*datum=evaluator-log.json`) written by Test-ReleasePerformance.ps1 into each results directory. Repeated runs of the
+same suite and mode (warm or cold) are combined using the median. Exits with a non-zero status if any query or
+predicate regressed by more than the configured thresholds, and writes a markdown report of the comparison.
+"""
+
+# Predicate names are suffixed with hashes that change whenever the predicate, or anything it depends on, changes.
+PREDICATE_HASH_SUFFIX_RE = re.compile(r"(#[0-9a-f]{6,})+$")
+
+
+def normalize_predicate_name(name):
+    return PREDICATE_HASH_SUFFIX_RE.sub("", name)
+
+
+def parse_result_path(path):
+    """Return the (release, platform, language, suite, mode) of an evaluator log in the Test-ReleasePerformance.ps1 layout."""
+    result = evaluator_log.parse_result_path(path)
+    return result["release"], result["platform"], result["language"], result["suite"], result["mode"]
+
+
+def load_runs(results_directory, release_filter=None):
+    """
+    Return, for each (platform, language, suite, mode), a list of per-run timings of queries and predicates. Each
+    evaluator log of a run of Test-ReleasePerformance.ps1, including each of its repetitions, is treated as a run.
+    """
+    runs = defaultdict(list)
+    for log_path in sorted(Path(results_directory).glob("release*/**/*datum=evaluator-log.json")):
+        release, platform, language, suite, mode = parse_result_path(log_path)
+        if release_filter and release != release_filter:
+            continue
+        events = list(iter_evaluator_log_events(log_path))
+        predicate_ms = defaultdict(float)
+        for event in events:
+            if is_computed_predicate_event(event):
+                predicate_ms[normalize_predicate_name(event["predicateName"])] += event["millis"]
+        query_costs, _ = attribute_query_costs(events)
+        query_ms = {query: costs["total_ms"] for query, costs in query_costs.items()}
+        runs[(platform, language, suite, mode)].append({"query": query_ms, "predicate": dict(predicate_ms)})
+    return runs
+
+
+def median_absolute_deviation(values):
+    median = statistics.median(values)
+    # Scaled so that it estimates the standard deviation of normally distributed values
+    return 1.4826 * statistics.median([abs(value - median) for value in values])
+
+
+class Comparison:
+    def __init__(self, kind, name, baseline, candidate):
+        self.kind = kind
+        self.name = name
+        self.baseline = baseline
+        self.candidate = candidate
+        self.baseline_median = statistics.median(baseline) if baseline else None
+        self.candidate_median = statistics.median(candidate) if candidate else None
+
+    @property
+    def delta(self):
+        return (self.candidate_median or 0) - (self.baseline_median or 0)
+
+    @property
+    def relative_delta(self):
+        if not self.baseline_median:
+            return None
+        return self.delta / self.baseline_median
+
+    def noise(self):
+        """An estimate of the run to run variation, which is only available with repeated runs of both releases."""
+        if len(self.baseline) < 2 or len(self.candidate) < 2:
+            return 0
+        return max(median_absolute_deviation(self.baseline), median_absolute_deviation(self.candidate))
+
+    def is_regression(self, threshold, minimum_ms, noise_factor):
+        if self.baseline_median is None or self.candidate_median is None:
+            return False
+        return (self.delta >= minimum_ms and
+                self.relative_delta is not None and self.relative_delta >= threshold and
+                self.delta > noise_factor * self.noise())
+
+    def is_new(self, minimum_ms):
+        return self.baseline_median is None and self.candidate_median is not None and self.candidate_median >= minimum_ms
+
+
+def compare(baseline_runs, candidate_runs, kind):
+    names = set()
+    for run in baseline_runs + candidate_runs:
+        names.update(run[kind].keys())
+    comparisons = []
+    for name in names:
+        baseline = [run[kind][name] for run in baseline_runs if name in run[kind]]
+        candidate = [run[kind][name] for run in candidate_runs if name in run[kind]]
+        comparisons.append(Comparison(kind, name, baseline, candidate))
+    return comparisons
+
+
+def format_ms(value):
+    return "-" if value is None else f"{value:,.0f}"
+
+
+def format_relative(value):
+    return "-" if value is None else f"{value:+.1%}"
+
+
+def write_table(output, comparisons):
+    output.write("| Name | Baseline (ms) | Candidate (ms) | Delta (ms) | Delta (%) | Runs |\n")
+    output.write("| --- | ---: | ---: | ---: | ---: | --- |\n")
+    for comparison in comparisons:
+        name = comparison.name.replace("|", "\\|")
+        output.write(f"| `{name}` | {format_ms(comparison.baseline_median)} | {format_ms(comparison.candidate_median)} | {format_ms(comparison.delta)} | {format_relative(comparison.relative_delta)} | {len(comparison.baseline)}/{len(comparison.candidate)} |\n")
+    output.write("\n")
+
+
+def generate_report(baseline, candidate, description, threshold_percent, minimum_ms, noise_factor, top):
+    """Compare the runs loaded by `load_runs`, returning the markdown report and the number of regressions."""
+    threshold = threshold_percent / 100
+    total_regressions = 0
+    output = io.StringIO()
+    output.write("# Performance comparison\n\n")
+    output.write(f"{description} A regression is an increase of at least {threshold_percent:g}% and {minimum_ms:g} ms")
+    output.write(f" which, with repeated runs, exceeds {noise_factor:g} times the median absolute deviation of the run times.\n\n")
+
+    for configuration in sorted(set(baseline.keys()) | set(candidate.keys())):
+        platform, language, suite, mode = configuration
+        output.write(f"## Platform={platform}, Language={language}, Suite={suite}, Mode={mode}\n\n")
+        if not configuration in baseline or not configuration in candidate:
+            output.write(f"Only available for the {'baseline' if configuration in baseline else 'candidate'}, skipping.\n\n")
+            continue
+
+        for kind, title in [("query", "Queries"), ("predicate", "Predicates")]:
+            comparisons = compare(baseline[configuration], candidate[configuration], kind)
+            regressions = sorted([comparison for comparison in comparisons if comparison.is_regression(threshold, minimum_ms, noise_factor)],
+                                 key=lambda comparison: comparison.delta, reverse=True)
+            improvements = sorted([comparison for comparison in comparisons if comparison.delta <= -minimum_ms and comparison.candidate_median is not None],
+                                  key=lambda comparison: comparison.delta)[:top]
+            new = sorted([comparison for comparison in comparisons if comparison.is_new(minimum_ms)],
+                         key=lambda comparison: comparison.delta, reverse=True)[:top]
+            total_regressions += len(regressions)
+
+            output.write(f"### {title}\n\n")
+            if regressions:
+                output.write(f"**{len(regressions)} regression(s)**\n\n")
+                write_table(output, regressions)
+            else:
+                output.write("No regressions.\n\n")
+            if improvements:
+                output.write("Largest improvements:\n\n")
+                write_table(output, improvements)
+            if new:
+                output.write(f"Largest new {title.lower()}:\n\n")
+                write_table(output, new)
+
+    output.write(f"**Result**: {'FAILED' if total_regressions > 0 else 'PASSED'} with {total_regressions} regression(s).\n")
+
+    return output.getvalue(), total_regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog='compare_performance', description=help_statement)
+    parser.add_argument('baseline', type=Path,
+                        help='The results directory of the baseline release.')
+    parser.add_argument('candidate', type=Path,
+                        help='The results directory of the candidate release.')
+    parser.add_argument('--baseline-release', required=False,
+                        help='Only use the runs of this release from the baseline results directory.')
+    parser.add_argument('--candidate-release', required=False,
+                        help='Only use the runs of this release from the candidate results directory.')
+    parser.add_argument('--threshold', type=float, default=20,
+                        help='The relative increase, in percent, above which a query or predicate is considered to have regressed.')
+    parser.add_argument('--minimum-ms', type=float, default=1000,
+                        help='The absolute increase, in milliseconds, below which changes are ignored.')
+    parser.add_argument('--noise-factor', type=float, default=3,
+                        help='With repeated runs, the number of median absolute deviations an increase must exceed to be considered a regression.')
+    parser.add_argument('--top', type=int, default=20,
+                        help='The number of largest improvements and new predicates to report.')
+    parser.add_argument('--output', type=Path, required=False,
+                        help='Write the markdown report to this file instead of standard output.')
+    args = parser.parse_args()
+
+    baseline = load_runs(args.baseline, args.baseline_release)
+    candidate = load_runs(args.candidate, args.candidate_release)
+    if not baseline:
+        print(f"No evaluator logs found in {args.baseline}.", file=sys.stderr)
+        sys.exit(2)
+    if not candidate:
+        print(f"No evaluator logs found in {args.candidate}.", file=sys.stderr)
+        sys.exit(2)
+
+    report, regressions = generate_report(baseline, candidate, f"Baseline: `{args.baseline}`, candidate: `{args.candidate}`.",
+                                          args.threshold, args.minimum_ms, args.noise_factor, args.top)
+    if args.output:
+        args.output.write_text(report)
+    else:
+        print(report, end='')
+
+    sys.exit(1 if regressions > 0 else 0)
+
+
+if __name__ == '__main__':
+    main()
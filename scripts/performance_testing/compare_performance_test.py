@@ -0,0 +1,49 @@
+import json
+from compare_performance import load_runs, generate_report, normalize_predicate_name
+
+
+def write_run(results_path, release, tested_on, predicate_millis):
+    run_path = results_path / f"release={release},testedOn={tested_on}" / "platform=x86-linux" / "language=cpp"
+    run_path.mkdir(parents=True)
+    events = []
+    for index, (name, millis) in enumerate(predicate_millis.items()):
+        events.append({
+            "raHash": f"{release}{index}",
+            "predicateName": name,
+            "evaluationStrategy": "COMPUTE_SIMPLE",
+            "millis": millis,
+            "appearsAs": {name: {"/codeql-coding-standards/cpp/autosar/src/rules/Q.ql": [1]}}
+        })
+    with open(run_path / "suite=autosar-default,datum=evaluator-log.json", 'w') as log_file:
+        log_file.write("\n\n".join(json.dumps(event, indent=2) for event in events))
+
+
+def test_normalize_predicate_name():
+    assert(normalize_predicate_name("Foo::bar#3f2a1b4c#ff") == "Foo::bar#3f2a1b4c#ff")
+    assert(normalize_predicate_name("Foo::bar#3f2a1b4c#a0b1c2d3") == "Foo::bar")
+
+
+def test_regression_detected(tmp_path):
+    for run, millis in enumerate([1000, 1100, 900]):
+        write_run(tmp_path / "baseline", "v1", run, {"Stable#aaaaaaaa": 5000, "Slower#bbbbbbbb": millis})
+        write_run(tmp_path / "candidate", "v2", run, {"Stable#cccccccc": 5100, "Slower#dddddddd": millis * 4})
+
+    baseline = load_runs(tmp_path / "baseline")
+    candidate = load_runs(tmp_path / "candidate")
+    assert(len(baseline[("x86-linux", "cpp", "autosar-default", "cold")]) == 3)
+
+    report, regressions = generate_report(baseline, candidate, "", 20, 1000, 3, 10)
+    # Both the predicate and the query consuming it regressed
+    assert(regressions == 2)
+    assert("`Slower`" in report)
+    assert("`Stable`" not in report)
+    assert("FAILED" in report)
+
+
+def test_noisy_increase_ignored(tmp_path):
+    for run, (baseline_millis, candidate_millis) in enumerate([(2000, 3000), (5000, 6500), (8000, 9000)]):
+        write_run(tmp_path / "baseline", "v1", run, {"Noisy": baseline_millis})
+        write_run(tmp_path / "candidate", "v2", run, {"Noisy": candidate_millis})
+
+    _, regressions = generate_report(load_runs(tmp_path / "baseline"), load_runs(tmp_path / "candidate"), "", 20, 1000, 3, 10)
+    assert(regressions == 0)
@@ -0,0 +1,163 @@
+import argparse
+import csv
+from pathlib import Path
+import sys
+import tempfile
+from query_compilation import repository_root, get_source_roots, get_suites, resolve_queries, compile_queries, get_module_path, find_transitive_imports
+
+help_statement = """
+Measure the compilation time of the queries of the Coding Standards suites, and of the libraries of the common packs.
+
+Each query and library is compiled on its own with an empty compilation cache, so that the measured time includes the
+compilation of every library it depends on. A library is measured by compiling a query which only imports it. The
+time taken to compile a query which only imports `cpp` is measured as the baseline, and subtracted to report the time
+attributable to the Coding Standards libraries.
+
+The times are written to `compile-times,datum=queries.csv` and `compile-times,datum=libraries.csv` in the output
+directory. If a baseline directory written by a previous run is given, the script exits with a non-zero status if the
+compilation time of any query or library regressed by more than the configured thresholds.
+"""
+
+BENCHMARK_QUERY_NAME = "CompileBenchmark.ql"
+
+QUERIES_CSV = "compile-times,datum=queries.csv"
+LIBRARIES_CSV = "compile-times,datum=libraries.csv"
+
+
+def measure_compilation(query, codeql, threads):
+    """Return the time in milliseconds to compile the query with an empty compilation cache, or None on failure."""
+    with tempfile.TemporaryDirectory() as compilation_cache:
+        elapsed_ms, process = compile_queries([query], compilation_cache, codeql, threads)
+    if process.returncode != 0:
+        print(f"Failed to compile {query}:\n{process.stderr}", file=sys.stderr)
+        return None
+    return elapsed_ms
+
+
+def measure_import(pack_root, module, codeql, threads):
+    """Return the time in milliseconds to compile a query in the given pack that only imports the given module."""
+    query = Path(pack_root, BENCHMARK_QUERY_NAME)
+    query.write_text(f"import {module}\n\nselect 1\n", encoding="utf-8")
+    try:
+        return measure_compilation(query, codeql, threads)
+    finally:
+        query.unlink()
+
+
+def count_importing_queries(queries, source_roots):
+    """Return the number of queries which import each library, directly or indirectly."""
+    imports_cache = {}
+    counts = {}
+    for query in queries:
+        for library in find_transitive_imports(query, source_roots, imports_cache):
+            counts[library] = counts.get(library, 0) + 1
+    return counts
+
+
+def read_times(csv_path, key_column):
+    with open(csv_path, newline='') as csv_file:
+        return {row[key_column]: float(row["CompileMsAboveBaseline"]) for row in csv.DictReader(csv_file)
+                if row["CompileMsAboveBaseline"]}
+
+
+def find_regressions(baseline_times, candidate_times, threshold_percent, minimum_ms):
+    """
+    Return a list of (name, baseline ms, candidate ms) for each entry whose compilation time increased by at least
+    `threshold_percent` percent and `minimum_ms` milliseconds, sorted by the largest increase first.
+    """
+    regressions = []
+    for name, candidate_ms in candidate_times.items():
+        if name not in baseline_times:
+            continue
+        baseline_ms = baseline_times[name]
+        increase_ms = candidate_ms - baseline_ms
+        if increase_ms >= minimum_ms and increase_ms >= baseline_ms * threshold_percent / 100:
+            regressions.append((name, baseline_ms, candidate_ms))
+    return sorted(regressions, key=lambda regression: regression[1] - regression[2])
+
+
+def write_times(csv_path, key_column, rows):
+    with open(csv_path, 'w', newline='') as csv_file:
+        writer = csv.writer(csv_file)
+        writer.writerow([key_column, "CompileMs", "CompileMsAboveBaseline", "ImportingQueries"])
+        for row in sorted(rows, key=lambda row: -(row[2] or 0)):
+            writer.writerow(["" if value is None else round(value) if isinstance(value, float) else value
+                             for value in row])
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog='compile_benchmark', description=help_statement, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--output-directory', type=Path, default=Path.cwd(),
+                        help='The directory to write the compilation times to.')
+    parser.add_argument('--suite', action='append', dest='suites',
+                        help='A glob pattern of the suites whose queries are measured. May be given more than once. Defaults to all `*-default.qls` suites.')
+    parser.add_argument('--library', action='append', dest='libraries',
+                        help='A glob pattern, relative to the repository root, of the libraries to measure. May be given more than once. Defaults to all libraries of the common packs.')
+    parser.add_argument('--skip-queries', action='store_true',
+                        help='Only measure the libraries.')
+    parser.add_argument('--baseline', type=Path, required=False,
+                        help='A directory containing the compilation times of a previous run to compare against.')
+    parser.add_argument('--threshold', type=float, default=20,
+                        help='The percentage increase in compilation time reported as a regression.')
+    parser.add_argument('--minimum-ms', type=float, default=2000,
+                        help='The minimum increase in compilation time, in milliseconds, reported as a regression.')
+    parser.add_argument('--threads', type=int, default=0,
+                        help='The number of threads to compile with. Defaults to one per core.')
+    parser.add_argument('--codeql', default='codeql',
+                        help='The CodeQL CLI executable.')
+    args = parser.parse_args()
+
+    source_roots = get_source_roots()
+    suites = get_suites(args.suites or ["*-default.qls"])
+    queries = resolve_queries(suites, args.codeql) if suites else []
+    libraries = sorted(set(library for pattern in (args.libraries or ["c*/common/src/**/*.qll"])
+                           for library in repository_root.glob(pattern)))
+
+    baseline_ms = measure_import(repository_root / "cpp" / "common" / "src", "cpp", args.codeql, args.threads)
+    if baseline_ms is None:
+        sys.exit(1)
+    print(f"Compiling a query which only imports `cpp` takes {baseline_ms:.0f}ms.", file=sys.stderr)
+
+    def above_baseline(ms):
+        return None if ms is None else max(ms - baseline_ms, 0.0)
+
+    args.output_directory.mkdir(parents=True, exist_ok=True)
+    query_rows = []
+    if not args.skip_queries:
+        for index, query in enumerate(queries):
+            print(f"[{index + 1}/{len(queries)}] Compiling {query}", file=sys.stderr)
+            ms = measure_compilation(query, args.codeql, args.threads)
+            query_rows.append([Path(query).relative_to(repository_root).as_posix(), ms, above_baseline(ms), ""])
+        write_times(args.output_directory / QUERIES_CSV, "Query", query_rows)
+
+    importing_queries = count_importing_queries(queries, source_roots)
+    library_rows = []
+    for index, library in enumerate(libraries):
+        module = get_module_path(library, source_roots)
+        if module is None:
+            continue
+        print(f"[{index + 1}/{len(libraries)}] Compiling {module}", file=sys.stderr)
+        pack_root = next(root for root in source_roots if root in library.parents)
+        ms = measure_import(pack_root, module, args.codeql, args.threads)
+        library_rows.append([library.relative_to(repository_root).as_posix(), ms, above_baseline(ms),
+                             importing_queries.get(library, 0)])
+    write_times(args.output_directory / LIBRARIES_CSV, "Library", library_rows)
+
+    if args.baseline:
+        regressed = False
+        for csv_name, key_column in [(QUERIES_CSV, "Query"), (LIBRARIES_CSV, "Library")]:
+            if not (args.baseline / csv_name).exists() or not (args.output_directory / csv_name).exists():
+                continue
+            regressions = find_regressions(read_times(args.baseline / csv_name, key_column),
+                                           read_times(args.output_directory / csv_name, key_column),
+                                           args.threshold, args.minimum_ms)
+            for name, old_ms, new_ms in regressions:
+                print(f"Compilation regression in {name}: {old_ms:.0f}ms -> {new_ms:.0f}ms", file=sys.stderr)
+            regressed = regressed or len(regressions) > 0
+        if regressed:
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,33 @@
+from compile_benchmark import count_importing_queries, find_regressions
+from query_compilation import get_module_path
+
+
+def write_file(path, contents):
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_text(contents)
+    return path
+
+
+def test_count_importing_queries(tmp_path):
+    common = tmp_path / "cpp/common/src"
+    autosar = tmp_path / "cpp/autosar/src"
+    write_file(common / "codingstandards/cpp/A.qll", "import cpp\nprivate import codingstandards.cpp.B\n")
+    write_file(common / "codingstandards/cpp/B.qll", "import cpp\n")
+    write_file(common / "codingstandards/cpp/C.qll", "import codingstandards.cpp.A\n")
+    query1 = write_file(autosar / "rules/Q1.ql", "import cpp\nimport codingstandards.cpp.A\n")
+    query2 = write_file(autosar / "rules/Q2.ql", "import codingstandards.cpp.B\n")
+
+    counts = count_importing_queries([query1, query2], [autosar, common])
+    assert(counts == {
+        common / "codingstandards/cpp/A.qll": 1,
+        common / "codingstandards/cpp/B.qll": 2
+    })
+    assert(get_module_path(common / "codingstandards/cpp/C.qll", [autosar, common]) == "codingstandards.cpp.C")
+
+
+def test_find_regressions():
+    baseline = {"A.qll": 10000, "B.qll": 1000, "C.qll": 10000, "Removed.qll": 5000}
+    candidate = {"A.qll": 13000, "B.qll": 2500, "C.qll": 10500, "New.qll": 50000}
+    # B.qll increased by more than the percentage threshold, but less than the minimum time
+    assert(find_regressions(baseline, candidate, 20, 2000) == [("A.qll", 10000, 13000)])
+    assert(find_regressions(baseline, candidate, 20, 1000) == [("A.qll", 10000, 13000), ("B.qll", 1000, 2500)])
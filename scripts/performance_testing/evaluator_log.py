@@ -0,0 +1,304 @@
+"""
+Utilities for reading the evaluator log summaries produced by `codeql generate log-summary`.
+
+A log summary is a sequence of JSON objects, one per evaluation event, separated by blank lines (or one per line when
+minified). Events for evaluated predicates record the predicate name, the evaluation strategy, the time taken in
+`millis`, the result size, the RA hashes of the predicates it depends on and, in `appearsAs`, the queries in which the
+predicate appears.
+"""
+from collections import defaultdict
+import json
+from pathlib import Path
+
+# Evaluation strategies for which the predicate was actually computed during this run
+COMPUTED_STRATEGIES = {"COMPUTE_SIMPLE", "COMPUTE_RECURSIVE", "IN_LAYER"}
+
+
+def iter_evaluator_log_events(log_path):
+    """Stream the events from an evaluator log summary, without loading the whole file."""
+    with open(log_path, 'r') as log_file:
+        buffer = []
+        for line in log_file:
+            stripped = line.strip()
+            if not stripped:
+                if buffer:
+                    yield json.loads(''.join(buffer))
+                    buffer = []
+                continue
+            if not buffer and stripped.startswith('{') and stripped.endswith('}'):
+                # A minified log has one event per line, but a pretty printed event may also fit on one line
+                try:
+                    yield json.loads(stripped)
+                    continue
+                except json.JSONDecodeError:
+                    pass
+            buffer.append(line)
+        if buffer:
+            yield json.loads(''.join(buffer))
+
+
+def is_computed_predicate_event(event):
+    """Holds if the event records the computation of a predicate in this run."""
+    return ("predicateName" in event and
+            event["predicateName"] != "output" and
+            event.get("evaluationStrategy") in COMPUTED_STRATEGIES and
+            "millis" in event)
+
+
+def get_query_name(query_path):
+    """Return a stable name for a query path recorded in the log, relative to the pack's `src` directory if possible."""
+    parts = Path(query_path).parts
+    if "src" in parts:
+        index = len(parts) - 1 - parts[::-1].index("src")
+        return "/".join(parts[index + 1:])
+    return Path(query_path).as_posix()
+
+
+def get_appears_as_queries(event):
+    """Return the queries in which the predicate of the event appears directly."""
+    queries = set()
+    for query_stages in event.get("appearsAs", {}).values():
+        queries.update(get_query_name(query_path) for query_path in query_stages.keys())
+    return queries
+
+
+class PredicateGraph:
+    """
+    The dependency graph of the predicates computed in a run, keyed by RA hash, together with the queries that
+    consume each predicate, either directly or through the predicates that depend on it.
+    """
+
+    def __init__(self, events):
+        self.predicate_name = {}
+        self.millis = defaultdict(int)
+        self.result_size = {}
+        self.dependencies = defaultdict(set)
+        self.direct_queries = defaultdict(set)
+        self.query_causing_work = {}
+
+        for event in events:
+            if not "raHash" in event or not "predicateName" in event:
+                continue
+            ra_hash = event["raHash"]
+            self.predicate_name[ra_hash] = event["predicateName"]
+            self.dependencies[ra_hash].update(event.get("dependencies", {}).values())
+            self.direct_queries[ra_hash].update(get_appears_as_queries(event))
+            if "queryCausingWork" in event:
+                self.query_causing_work[ra_hash] = get_query_name(event["queryCausingWork"])
+            if is_computed_predicate_event(event):
+                # Recursive predicates are reported once per iteration layer, so accumulate the time
+                self.millis[ra_hash] += event["millis"]
+                if "resultSize" in event:
+                    self.result_size[ra_hash] = event["resultSize"]
+
+        self.consumers = self._compute_consumers()
+
+    def _compute_consumers(self):
+        """Propagate the consuming queries of each predicate down to its dependencies."""
+        dependents = defaultdict(set)
+        for ra_hash, dependencies in self.dependencies.items():
+            for dependency in dependencies:
+                dependents[dependency].add(ra_hash)
+
+        consumers = {}
+        # Iterative depth-first traversal, because the dependency chains can exceed the Python recursion limit
+        for root in self.predicate_name.keys():
+            if root in consumers:
+                continue
+            stack = [(root, False)]
+            while stack:
+                ra_hash, expanded = stack.pop()
+                if ra_hash in consumers:
+                    continue
+                if not expanded:
+                    stack.append((ra_hash, True))
+                    for dependent in dependents[ra_hash]:
+                        if not dependent in consumers:
+                            stack.append((dependent, False))
+                    continue
+                queries = set(self.direct_queries[ra_hash])
+                for dependent in dependents[ra_hash]:
+                    # Dependents on a cycle may not be complete yet, in which case their direct queries are used
+                    queries.update(consumers.get(dependent, self.direct_queries[dependent]))
+                if not queries and ra_hash in self.query_causing_work:
+                    queries.add(self.query_causing_work[ra_hash])
+                consumers[ra_hash] = frozenset(queries)
+        return consumers
+
+
+def attribute_query_costs(events, split="proportional"):
+    """
+    Attribute the evaluation time of each predicate to the queries that consume it.
+
+    The time of a predicate consumed by a single query is attributed to that query. The time of a predicate shared
+    by several queries is either split equally between them (`split="equal"`), or in proportion to the time of the
+    predicates used exclusively by each of them (`split="proportional"`), so that a shared predicate is mostly charged
+    to the queries that already do the most work of their own.
+
+    Returns a tuple of:
+     - a dict from query name to a dict with the `exclusive_ms`, `shared_ms` and `total_ms` attributed to the query and
+       the number of `predicates` it consumes;
+     - a dict from `(query, predicate name)` to the time in milliseconds attributed to the query for that predicate.
+    """
+    if not split in ("proportional", "equal"):
+        raise ValueError(f"Unknown split strategy {split}")
+
+    graph = PredicateGraph(events)
+
+    exclusive_ms = defaultdict(float)
+    predicate_counts = defaultdict(int)
+    for ra_hash, millis in graph.millis.items():
+        consumers = graph.consumers.get(ra_hash, frozenset())
+        for query in consumers:
+            predicate_counts[query] += 1
+        if len(consumers) == 1:
+            exclusive_ms[next(iter(consumers))] += millis
+
+    shared_ms = defaultdict(float)
+    attribution = defaultdict(float)
+    for ra_hash, millis in graph.millis.items():
+        consumers = graph.consumers.get(ra_hash, frozenset())
+        if not consumers:
+            consumers = frozenset(["<unattributed>"])
+        predicate_name = graph.predicate_name[ra_hash]
+        if len(consumers) == 1:
+            attribution[(next(iter(consumers)), predicate_name)] += millis
+            continue
+        weights = {query: exclusive_ms[query] for query in consumers} if split == "proportional" else {}
+        total_weight = sum(weights.values())
+        for query in consumers:
+            share = millis * weights[query] / total_weight if total_weight > 0 else millis / len(consumers)
+            shared_ms[query] += share
+            attribution[(query, predicate_name)] += share
+
+    costs = {}
+    for query in set(exclusive_ms.keys()) | set(shared_ms.keys()) | set(predicate_counts.keys()):
+        costs[query] = {
+            "exclusive_ms": exclusive_ms[query],
+            "shared_ms": shared_ms[query],
+            "total_ms": exclusive_ms[query] + shared_ms[query],
+            "predicates": predicate_counts[query]
+        }
+    return costs, attribution
+
+
+def get_pipeline_tuple_counts(event):
+    """
+    Return the sum and the maximum of the tuple counts of the RA operations in the pipelines evaluated for the event.
+    The counts are only recorded when the queries are run with `--tuple-counting`.
+    """
+    counts = [count for pipeline_run in event.get("pipelineRuns", []) for count in pipeline_run.get("counts", [])]
+    return sum(counts), max(counts, default=0)
+
+
+def get_predicate_statistics(events):
+    """
+    Return, for each predicate computed in the run, a dict with the predicate `name`, evaluation `strategy`, `millis`,
+    `result_size`, the number of `pipeline_runs`, the `total_tuples` and `max_tuples` of its RA pipelines and the
+    `query_causing_work`, ordered by decreasing time. Recursive predicates are reported once per iteration layer, so
+    the events are combined by RA hash.
+    """
+    statistics = {}
+    for event in events:
+        if not is_computed_predicate_event(event) or not "raHash" in event:
+            continue
+        total_tuples, max_tuples = get_pipeline_tuple_counts(event)
+        predicate = statistics.setdefault(event["raHash"], {
+            "name": event["predicateName"],
+            "strategy": event["evaluationStrategy"],
+            "millis": 0,
+            "result_size": 0,
+            "pipeline_runs": 0,
+            "total_tuples": 0,
+            "max_tuples": 0,
+            "query_causing_work": get_query_name(event["queryCausingWork"]) if "queryCausingWork" in event else None
+        })
+        predicate["millis"] += event["millis"]
+        predicate["result_size"] = max(predicate["result_size"], event.get("resultSize", 0))
+        predicate["pipeline_runs"] += len(event.get("pipelineRuns", []))
+        predicate["total_tuples"] += total_tuples
+        predicate["max_tuples"] = max(predicate["max_tuples"], max_tuples)
+    return sorted(statistics.values(), key=lambda predicate: predicate["millis"], reverse=True)
+
+
+def get_query_evaluation_times(events):
+    """
+    Return the wall time, in milliseconds, of evaluating each query, which is the time of the predicates that were
+    computed on behalf of the query. A shared predicate is only computed once, by the first query to require it, so
+    see `attribute_query_costs` for a measure of the cost of a query that does not depend on the evaluation order.
+    """
+    times = defaultdict(float)
+    for event in events:
+        if is_computed_predicate_event(event) and "queryCausingWork" in event:
+            times[get_query_name(event["queryCausingWork"])] += event["millis"]
+    return dict(times)
+
+
+def write_folded_stacks(attribution, output_path):
+    """Write the attributed costs in the folded stack format understood by flame graph tools."""
+    with open(output_path, 'w') as output_file:
+        for (query, predicate_name), millis in sorted(attribution.items()):
+            if millis <= 0:
+                continue
+            # Frames are separated by semicolons, so they must not appear in the frame names
+            frames = [query.replace(';', ':'), predicate_name.replace(';', ':')]
+            output_file.write(f"{';'.join(frames)} {round(millis)}\n")
+
+
+def parse_result_path(path):
+    """
+    Return a dict with the `release`, `tested_on`, `platform`, `language`, `suite`, `mode` and `run` of an evaluator
+    log in the Test-ReleasePerformance.ps1 layout. Logs written before repeated runs were supported do not record a
+    mode or run, and are from a single cold run.
+    """
+    parts = Path(path).parts
+    release_attributes = dict(attribute.split("=", 1) for attribute in parts[-4].split(","))
+    attributes = dict(attribute.split("=", 1) for attribute in parts[-1].split(".")[0].split(","))
+    return {
+        "release": release_attributes["release"],
+        "tested_on": release_attributes.get("testedOn"),
+        "platform": parts[-3].split("=", 1)[1],
+        "language": parts[-2].split("=", 1)[1],
+        "suite": attributes["suite"],
+        "mode": attributes.get("mode", "cold"),
+        "run": attributes.get("run", "1"),
+    }
+
+
+def select_latest_runs(log_paths):
+    """
+    Group the evaluator logs by release, platform, language, suite and mode, keeping only the repetitions of the
+    latest test of each group. Returns a dict from `(release, platform, language, suite, mode)` to a list of the
+    parsed paths of the repetitions, each with its `path`, sorted by run.
+    """
+    runs = {}
+    for log_path in log_paths:
+        result = parse_result_path(log_path)
+        result["path"] = Path(log_path)
+        key = (result["release"], result["platform"], result["language"], result["suite"], result["mode"])
+        existing = runs.get(key)
+        if existing is None or existing[0]["tested_on"] < result["tested_on"]:
+            runs[key] = [result]
+        elif existing[0]["tested_on"] == result["tested_on"]:
+            existing.append(result)
+    for repetitions in runs.values():
+        repetitions.sort(key=lambda result: int(result["run"]) if result["run"].isdigit() else result["run"])
+    return runs
+
+
+def average_query_costs(repetitions):
+    """
+    Average the `(query costs, attribution)` pairs returned by `attribute_query_costs` for repetitions of the same
+    run. A query or predicate missing from a repetition, for example because it was a cache hit, counts as zero.
+    """
+    count = len(repetitions)
+    query_costs = defaultdict(lambda: {"exclusive_ms": 0.0, "shared_ms": 0.0, "total_ms": 0.0, "predicates": 0})
+    attribution = defaultdict(float)
+    for repetition_costs, repetition_attribution in repetitions:
+        for query, costs in repetition_costs.items():
+            for key in ("exclusive_ms", "shared_ms", "total_ms"):
+                query_costs[query][key] += costs[key] / count
+            query_costs[query]["predicates"] = max(query_costs[query]["predicates"], costs["predicates"])
+        for key, millis in repetition_attribution.items():
+            attribution[key] += millis / count
+    return dict(query_costs), dict(attribution)
@@ -0,0 +1,110 @@
+import json
+from pathlib import Path
+import pytest
+from evaluator_log import iter_evaluator_log_events, attribute_query_costs, write_folded_stacks, get_predicate_statistics, get_query_evaluation_times, parse_result_path, select_latest_runs, average_query_costs
+
+
+def predicate_event(ra_hash, name, millis, queries=(), dependencies=(), strategy="COMPUTE_SIMPLE"):
+    return {
+        "raHash": ra_hash,
+        "predicateName": name,
+        "evaluationStrategy": strategy,
+        "millis": millis,
+        "resultSize": 1,
+        "appearsAs": {name: {f"/codeql-coding-standards/cpp/autosar/src/rules/{query}.ql": [1] for query in queries}},
+        "dependencies": {f"dep{index}": dependency for index, dependency in enumerate(dependencies)}
+    }
+
+
+def write_log(path, events, minify=False):
+    with open(path, 'w') as log_file:
+        separator = "\n" if minify else "\n\n"
+        log_file.write(separator.join(json.dumps(event, indent=None if minify else 2) for event in events))
+
+
+@pytest.mark.parametrize("minify", [False, True])
+def test_iter_evaluator_log_events(tmp_path, minify):
+    events = [predicate_event("a", "A", 1), {"completionType": "SUCCESS"}]
+    log_path = tmp_path / "evaluator-log.json"
+    write_log(log_path, events, minify)
+    assert(list(iter_evaluator_log_events(log_path)) == events)
+
+
+def test_attribute_query_costs():
+    events = [
+        # A shared predicate, only consumed by the queries through the predicates depending on it
+        predicate_event("shared", "Shared", 90),
+        predicate_event("q1", "Q1#exclusive", 20, queries=["Q1"], dependencies=["shared"]),
+        predicate_event("q2", "Q2#exclusive", 10, queries=["Q2"], dependencies=["shared"]),
+        predicate_event("cached", "Cached", 0, strategy="CACHE_HIT", queries=["Q2"])
+    ]
+
+    costs, attribution = attribute_query_costs(events)
+    assert(costs["rules/Q1.ql"]["exclusive_ms"] == 20)
+    assert(costs["rules/Q1.ql"]["shared_ms"] == pytest.approx(60))
+    assert(costs["rules/Q2.ql"]["shared_ms"] == pytest.approx(30))
+    assert(sum(query_costs["total_ms"] for query_costs in costs.values()) == pytest.approx(120))
+    assert(attribution[("rules/Q1.ql", "Shared")] == pytest.approx(60))
+
+    costs, _ = attribute_query_costs(events, split="equal")
+    assert(costs["rules/Q1.ql"]["shared_ms"] == pytest.approx(45))
+    assert(costs["rules/Q2.ql"]["shared_ms"] == pytest.approx(45))
+
+
+def test_write_folded_stacks(tmp_path):
+    stacks_path = tmp_path / "stacks.folded"
+    write_folded_stacks({("rules/Q1.ql", "A;B"): 10.4, ("rules/Q2.ql", "C"): 0}, stacks_path)
+    assert(stacks_path.read_text() == "rules/Q1.ql;A:B 10\n")
+
+
+def test_get_predicate_statistics():
+    query = "/codeql-coding-standards/cpp/autosar/src/rules/Q1.ql"
+    layers = [predicate_event("rec", "Rec", millis, strategy="IN_LAYER") for millis in (5, 7)]
+    for layer, counts in zip(layers, ([10, 4], [30, 12])):
+        layer["pipelineRuns"] = [{"raReference": "pipeline", "counts": counts}]
+        layer["queryCausingWork"] = query
+    simple = predicate_event("simple", "Simple", 20)
+    simple["queryCausingWork"] = query
+    events = layers + [simple, predicate_event("cached", "Cached", 0, strategy="CACHE_HIT")]
+
+    statistics = get_predicate_statistics(events)
+    assert([predicate["name"] for predicate in statistics] == ["Simple", "Rec"])
+    recursive = statistics[1]
+    assert(recursive["millis"] == 12)
+    assert(recursive["pipeline_runs"] == 2)
+    assert(recursive["total_tuples"] == 56)
+    assert(recursive["max_tuples"] == 30)
+    assert(recursive["query_causing_work"] == "rules/Q1.ql")
+
+    assert(get_query_evaluation_times(events) == {"rules/Q1.ql": 32})
+
+
+def test_select_latest_runs():
+    def log_path(tested_on, attributes):
+        return Path(f"release=2.41.0,testedOn={tested_on}", "platform=linux", "language=cpp",
+                    f"suite=autosar,{attributes}datum=evaluator-log.json")
+
+    paths = [
+        log_path("2024-01-01_00-00-00", ""),
+        log_path("2024-02-01_00-00-00", "mode=cold,run=2,"),
+        log_path("2024-02-01_00-00-00", "mode=cold,run=1,"),
+        log_path("2024-02-01_00-00-00", "mode=warm,run=1,"),
+    ]
+    runs = select_latest_runs(paths)
+    assert(set(runs.keys()) == {("2.41.0", "linux", "cpp", "autosar", "cold"), ("2.41.0", "linux", "cpp", "autosar", "warm")})
+    cold_runs = runs[("2.41.0", "linux", "cpp", "autosar", "cold")]
+    assert([run["run"] for run in cold_runs] == ["1", "2"])
+    assert(all(run["tested_on"] == "2024-02-01_00-00-00" for run in cold_runs))
+    assert([run["path"] for run in runs[("2.41.0", "linux", "cpp", "autosar", "warm")]] == [paths[3]])
+    assert(parse_result_path(paths[0])["mode"] == "cold")
+
+
+def test_average_query_costs():
+    costs = {"exclusive_ms": 10.0, "shared_ms": 20.0, "total_ms": 30.0, "predicates": 3}
+    query_costs, attribution = average_query_costs([
+        ({"rules/Q1.ql": costs}, {("rules/Q1.ql", "A"): 30.0}),
+        ({}, {}),
+    ])
+    assert(query_costs["rules/Q1.ql"]["total_ms"] == pytest.approx(15))
+    assert(query_costs["rules/Q1.ql"]["predicates"] == 3)
+    assert(attribution[("rules/Q1.ql", "A")] == pytest.approx(15))
@@ -0,0 +1,57 @@
+import argparse
+import json
+from pathlib import Path
+import sys
+import tempfile
+from query_compilation import repository_root, get_codeql_version, get_pack_version, get_compilation_cache_key, get_suites, compile_queries
+
+help_statement = """
+Compile the queries of the Coding Standards suites into a reusable compilation cache. The cache is stored in a
+subdirectory of the cache directory named after the CodeQL CLI version and the version of the packs, and can be
+passed to later runs with `codeql database analyze --compilation-cache=<directory>`. The path of the compilation
+cache is printed on completion.
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog='precompile_queries', description=help_statement)
+    parser.add_argument('--cache-directory', type=Path,
+                        default=Path(tempfile.gettempdir(), "coding-standards-compilation-cache"),
+                        help='The directory in which compilation caches are stored.')
+    parser.add_argument('--suite', action='append', dest='suites',
+                        help='A glob pattern of the suites to compile, for example `autosar-default.qls`. May be given more than once. Defaults to all `*-default.qls` suites.')
+    parser.add_argument('--threads', type=int, default=0,
+                        help='The number of threads to compile with. Defaults to one per core.')
+    parser.add_argument('--precompile', action='store_true',
+                        help='Also write the compiled queries next to the query sources, as done when building the release query pack.')
+    parser.add_argument('--codeql', default='codeql',
+                        help='The CodeQL CLI executable.')
+    args = parser.parse_args()
+
+    suites = get_suites(args.suites or ["*-default.qls"])
+    if not suites:
+        print("No suites match the given patterns.", file=sys.stderr)
+        sys.exit(1)
+
+    codeql_version = get_codeql_version(args.codeql)
+    pack_version = get_pack_version()
+    compilation_cache = args.cache_directory / get_compilation_cache_key(codeql_version, pack_version)
+    compilation_cache.mkdir(parents=True, exist_ok=True)
+
+    print(f"Compiling {len(suites)} suites into {compilation_cache}...", file=sys.stderr)
+    extra_args = ["--compilation-cache-size=1024"] + (["--precompile"] if args.precompile else [])
+    elapsed_ms, process = compile_queries(suites, compilation_cache, args.codeql, args.threads, extra_args)
+    if process.returncode != 0:
+        print(process.stdout, process.stderr, sep="\n", file=sys.stderr)
+        sys.exit(process.returncode)
+
+    with open(compilation_cache / "cache-info.json", "w") as info_file:
+        json.dump({"codeql_version": codeql_version, "pack_version": pack_version,
+                   "suites": [suite.relative_to(repository_root).as_posix() for suite in suites]}, info_file, indent=2)
+    print(f"Compiled {len(suites)} suites in {elapsed_ms / 1000:.0f}s.", file=sys.stderr)
+    print(compilation_cache)
+
+
+if __name__ == '__main__':
+    main()
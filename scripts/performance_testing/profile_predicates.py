@@ -7,6 +7,7 @@ from pathlib import Path
 import json 
 import math
 import sys  
+from evaluator_log import iter_evaluator_log_events, attribute_query_costs, write_folded_stacks, select_latest_runs, average_query_costs
 # %%
 
 if len(sys.argv) < 2:
@@ -18,48 +19,9 @@ root_path = Path(sys.argv[1])
 # root_path = Path("../../performance_tests/")
 
 
-# We only process the LATEST run for a given release x suite x platform. To support this function
-# we loop over all of the possible CSV files and add a file to the "load" list
-# only if it has a newer `testedOn` value.
-datafiles = {}
-
-
-def path_to_tuple(path):
-    parts = path.parts
-
-    part_suite = parts[-1]
-    part_language = parts[-2]
-    part_platform = parts[-3]
-    part_release = parts[-4]
-
-    release = part_release.split(",")[0].split("=")[1]
-    testedOn = part_release.split(",")[1].split("=")[1]
-    platform = part_platform.split("=")[1]
-    language = part_language.split("=")[1]
-    suite = part_suite.split(".")[0].split("=")[1].split(",")[0]
-
-    return release, testedOn, platform, language, suite
-#%%
-
-for f in root_path.glob(f"release*/**/*datum=evaluator-log.json"):
-    release, testedOn, platform, language, suite = path_to_tuple(f)
-
-    hashEntry = {
-        "release": release,
-        "testedOn": testedOn,
-        "platform": platform,
-        "language": language,
-        "suite": suite,
-        "dataFile": f
-    }
-
-    if not release in datafiles.keys():
-        datafiles[(release, platform, suite, language)] = hashEntry
-    else:
-        existing = datafiles[(release, platform, suite, language)]
-
-        if existing["testedOn"] > testedOn:
-            datafiles[(release, platform, suite, language)] = hashEntry
+# We only process the LATEST run for a given release x platform x language x suite x mode (cold or warm). The
+# repetitions of that run are averaged, so that a warm run never replaces a cold one.
+datafiles = select_latest_runs(root_path.glob(f"release*/**/*datum=evaluator-log.json"))
 # %%
 summary_df = pd.DataFrame(columns=[
     'Release',
@@ -67,6 +29,7 @@ summary_df = pd.DataFrame(columns=[
     'Platform',
     'Language',
     'Suite',
+    'Mode',
     'Predicate',
     'Execution_Time_Ms'
 ])
@@ -78,51 +41,57 @@ new_rows = {
     'Platform': [],
     'Language': [],
     'Suite': [],
+    'Mode': [],
     'Predicate': [],
     'Execution_Time_Ms': []
 }
 
-for K, V in datafiles.items():
-    print(f"Loading {str(V['dataFile'])}...", end=None)
+for repetitions in datafiles.values():
+    for V in repetitions:
+        print(f"Loading {str(V['path'])}...", end=None)
     
-    # we need to load the data file and then parse each JSON row 
-    with open(V['dataFile'], 'r') as f:
-        json_line_data = f.read() 
-        #json_line_objects = re.split(r"(?m)^\n", json_line_data)
-        json_line_objects = json_line_data.split('\n\n')
+        # we need to load the data file and then parse each JSON row 
+        with open(V['path'], 'r') as f:
+            json_line_data = f.read() 
+            #json_line_objects = re.split(r"(?m)^\n", json_line_data)
+            json_line_objects = json_line_data.split('\n\n')
     
 
-    print(f"Done.")
+        print(f"Done.")
 
-    for json_line_object in json_line_objects:
+        for json_line_object in json_line_objects:
         
-        #print(".", end="None")
+            #print(".", end="None")
 
-        # quickly do this before bothering to parse the JSON
-        if not ("predicateName" in json_line_object and "COMPUTE_SIMPLE" in json_line_object):
-            continue 
+            # quickly do this before bothering to parse the JSON
+            if not ("predicateName" in json_line_object and "COMPUTE_SIMPLE" in json_line_object):
+                continue 
 
-        json_object = json.loads(json_line_object)
+            json_object = json.loads(json_line_object)
 
-        if not "predicateName" in json_object:
-            continue 
+            if not "predicateName" in json_object:
+                continue 
 
-        if json_object["predicateName"] == "output":
-            continue 
+            if json_object["predicateName"] == "output":
+                continue 
 
 
-        if not json_object["evaluationStrategy"] == "COMPUTE_SIMPLE":
-            continue 
+            if not json_object["evaluationStrategy"] == "COMPUTE_SIMPLE":
+                continue 
 
-        new_rows['Release'].append(V["release"])
-        new_rows['Run'].append(V["testedOn"])
-        new_rows['Platform'].append(V["platform"])
-        new_rows['Language'].append(V["language"])
-        new_rows['Suite'].append(V["suite"])
-        new_rows['Predicate'].append(json_object["predicateName"])
-        new_rows['Execution_Time_Ms'].append(json_object["millis"])
+            new_rows['Release'].append(V["release"])
+            new_rows['Run'].append(V["tested_on"])
+            new_rows['Platform'].append(V["platform"])
+            new_rows['Language'].append(V["language"])
+            new_rows['Suite'].append(V["suite"])
+            new_rows['Mode'].append(V["mode"])
+            new_rows['Predicate'].append(json_object["predicateName"])
+            # Average the repetitions, counting a predicate missing from a repetition as zero
+            new_rows['Execution_Time_Ms'].append(json_object["millis"] / len(repetitions))
 
 new_df = pd.DataFrame(new_rows)
+new_df = new_df.groupby(['Release', 'Run', 'Platform', 'Language', 'Suite', 'Mode', 'Predicate'],
+                        as_index=False)['Execution_Time_Ms'].sum()
 summary_df = pd.concat([summary_df, new_df])
 
 # %%
@@ -132,6 +101,7 @@ performance_df = pd.DataFrame(
         'Release',
         'Platform',
         'Language',
+        'Mode',
         'Total_Serialized_Execution_Time_Ms',
         'Mean_Predicate_Execution_Time_Ms',
         'Median_Predicate_Execution_Time_Ms',
@@ -144,15 +114,16 @@ performance_df = pd.DataFrame(
     ]
 )
 
-summary_df_grouped = summary_df.groupby(['Release', 'Platform', 'Language'])
+summary_df_grouped = summary_df.groupby(['Release', 'Platform', 'Language', 'Mode'])
 
 for _, df_group in summary_df_grouped:
 
     release = df_group["Release"].iloc[0]
     platform = df_group["Platform"].iloc[0]
     language = df_group["Language"].iloc[0]
+    mode = df_group["Mode"].iloc[0]
 
-    print(f"Processing Platform={platform}, Language={language}, Release={release}")
+    print(f"Processing Platform={platform}, Language={language}, Release={release}, Mode={mode}")
     
     
     execution_time = df_group["Execution_Time_Ms"].sum()
@@ -166,6 +137,7 @@ for _, df_group in summary_df_grouped:
         'Release' : [release],
         'Platform' : [platform],
         'Language' : [language],
+        'Mode' : [mode],
         'Total_Serialized_Execution_Time_Ms' : [execution_time],
         'Mean_Predicate_Execution_Time_Ms' : [execution_time_mean],
         'Median_Predicate_Execution_Time_Ms' : [execution_time_median],
@@ -191,13 +163,45 @@ for _, row in performance_df.iterrows():
     release = row["Release"]
     platform = row["Platform"]
     language = row["Language"]
+    mode = row["Mode"]
     percentile_95 = row["Percentile95_Ms"]
 
-    rpl_df = summary_df[(summary_df["Release"] == release) & (summary_df["Platform"] == platform) & (summary_df["Language"] == language)]
+    rpl_df = summary_df[(summary_df["Release"] == release) & (summary_df["Platform"] == platform) & (summary_df["Language"] == language) & (summary_df["Mode"] == mode)]
     g95 = rpl_df[(rpl_df["Execution_Time_Ms"] >= percentile_95)]
 
     g95 = g95.sort_values(by='Execution_Time_Ms', ascending=False)
 
-    g95.to_csv(root_path.joinpath(f"slow-log,datum=predicates,release={release},platform={platform},language={language}.csv"), index=False)
-
+    g95.to_csv(root_path.joinpath(f"slow-log,datum=predicates,release={release},platform={platform},language={language},mode={mode}.csv"), index=False)
 
+#%%
+# write out the cost of each query, attributing the time of predicates shared
+# between queries in proportion to the work each query does on its own, as
+# well as a folded stack file which can be rendered as a flame graph.
+for repetitions in datafiles.values():
+    V = repetitions[0]
+    print(f"Attributing query costs for {len(repetitions)} {V['mode']} runs of {V['suite']}...")
+
+    query_costs, attribution = average_query_costs(
+        [attribute_query_costs(iter_evaluator_log_events(repetition['path'])) for repetition in repetitions])
+
+    query_costs_df = pd.DataFrame([{
+        'Release': V["release"],
+        'Run': V["tested_on"],
+        'Platform': V["platform"],
+        'Language': V["language"],
+        'Suite': V["suite"],
+        'Mode': V["mode"],
+        'Repetitions': len(repetitions),
+        'Query': query,
+        'Exclusive_Execution_Time_Ms': costs["exclusive_ms"],
+        'Shared_Execution_Time_Ms': costs["shared_ms"],
+        'Attributed_Execution_Time_Ms': costs["total_ms"],
+        'Number_of_Predicates': costs["predicates"]
+    } for query, costs in query_costs.items()])
+
+    if len(query_costs_df) > 0:
+        query_costs_df = query_costs_df.sort_values(by='Attributed_Execution_Time_Ms', ascending=False)
+
+    suffix = f"release={V['release']},platform={V['platform']},language={V['language']},suite={V['suite']},mode={V['mode']}"
+    query_costs_df.to_csv(root_path.joinpath(f"query-costs,datum=queries,{suffix}.csv"), index=False)
+    write_folded_stacks(attribution, root_path.joinpath(f"query-costs,datum=stacks,{suffix}.folded"))
@@ -0,0 +1,95 @@
+import json
+from pathlib import Path
+import re
+import subprocess
+import time
+
+repository_root = Path(__file__).resolve().parent.parent.parent
+
+IMPORT_RE = re.compile(r"^\s*(?:private\s+)?import\s+([A-Za-z0-9_.]+)", re.MULTILINE)
+
+
+def get_codeql_version(codeql="codeql"):
+    output = subprocess.run([codeql, "version", "--format=json"], check=True, capture_output=True, text=True).stdout
+    return json.loads(output)["version"]
+
+
+def get_pack_version(root=repository_root):
+    """Return the version of the Coding Standards packs, which are all released with the same version."""
+    with open(Path(root, "cpp", "common", "src", "qlpack.yml")) as qlpack_file:
+        for line in qlpack_file:
+            if line.startswith("version:"):
+                return line.split(":", 1)[1].strip()
+    raise ValueError("Could not determine the version of the Coding Standards packs.")
+
+
+def get_compilation_cache_key(codeql_version, pack_version):
+    """Return the name of the compilation cache for a CodeQL CLI version and a version of the packs."""
+    return f"codeql-{codeql_version}-packs-{pack_version}"
+
+
+def get_source_roots(root=repository_root):
+    """Return the root directories of the Coding Standards query and library packs."""
+    return sorted(path.parent for path in Path(root).glob("c*/*/src/qlpack.yml"))
+
+
+def get_suites(patterns, root=repository_root):
+    """Return the suite files of the Coding Standards packs matching any of the given glob patterns."""
+    return sorted(suite for suite in Path(root).glob("c*/*/src/codeql-suites/*.qls")
+                  if any(suite.match(pattern) for pattern in patterns))
+
+
+def resolve_queries(targets, codeql="codeql"):
+    output = subprocess.run([codeql, "resolve", "queries", "--format=json"] + [str(target) for target in targets],
+                            check=True, capture_output=True, text=True).stdout
+    return sorted(Path(query) for query in json.loads(output))
+
+
+def compile_queries(targets, compilation_cache, codeql="codeql", threads=0, extra_args=None):
+    """
+    Compile the given queries, query directories or suites using the given compilation cache. Returns a tuple of the
+    elapsed time in milliseconds and the completed process.
+    """
+    command = [codeql, "query", "compile", f"--threads={threads}", f"--compilation-cache={compilation_cache}",
+               "--warnings=hide"] + (extra_args or []) + [str(target) for target in targets]
+    start = time.perf_counter()
+    process = subprocess.run(command, capture_output=True, text=True)
+    return (time.perf_counter() - start) * 1000, process
+
+
+def get_module_path(library_path, source_roots):
+    """Return the file of a library, relative to the root of its pack, as an importable module name."""
+    library_path = Path(library_path)
+    for source_root in source_roots:
+        try:
+            return ".".join(library_path.relative_to(source_root).with_suffix("").parts)
+        except ValueError:
+            continue
+    return None
+
+
+def find_imports(path, source_roots):
+    """Return the libraries of the Coding Standards packs that are imported by the given query or library."""
+    imports = set()
+    for module in IMPORT_RE.findall(Path(path).read_text(encoding="utf-8")):
+        relative_path = Path(*module.split(".")).with_suffix(".qll")
+        for source_root in source_roots:
+            if (source_root / relative_path).exists():
+                imports.add(source_root / relative_path)
+                break
+    return imports
+
+
+def find_transitive_imports(path, source_roots, cache):
+    """Return all libraries of the Coding Standards packs that are imported, directly or indirectly, by a file."""
+    visited = set()
+    pending = [Path(path)]
+    while pending:
+        current = pending.pop()
+        if current not in cache:
+            cache[current] = find_imports(current, source_roots)
+        for library in cache[current]:
+            if library not in visited:
+                visited.add(library)
+                pending.append(library)
+    return visited
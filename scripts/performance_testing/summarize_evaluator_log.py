@@ -0,0 +1,58 @@
+import argparse
+import csv
+from pathlib import Path
+import sys
+from evaluator_log import iter_evaluator_log_events, attribute_query_costs, get_predicate_statistics, get_query_evaluation_times
+
+help_statement = """
+Summarize an evaluator log summary, as produced by `codeql generate log-summary` from the `--evaluator-log` of a
+`codeql database analyze` run, into a CSV file of the time of each query and a CSV file of the time, tuple counts and
+RA pipeline sizes of each computed predicate. Used by Test-ReleasePerformance.ps1.
+"""
+
+
+def write_queries_csv(events, output_path):
+    evaluation_times = get_query_evaluation_times(events)
+    query_costs, _ = attribute_query_costs(events)
+    with open(output_path, 'w', newline='') as output_file:
+        writer = csv.writer(output_file)
+        writer.writerow(["Query", "TimeInMs", "ExclusiveTimeInMs", "SharedTimeInMs", "AttributedTimeInMs", "Predicates"])
+        for query in sorted(set(evaluation_times.keys()) | set(query_costs.keys())):
+            costs = query_costs.get(query, {"exclusive_ms": 0, "shared_ms": 0, "total_ms": 0, "predicates": 0})
+            writer.writerow([query, round(evaluation_times.get(query, 0)), round(costs["exclusive_ms"]),
+                             round(costs["shared_ms"]), round(costs["total_ms"]), costs["predicates"]])
+
+
+def write_predicates_csv(events, output_path):
+    with open(output_path, 'w', newline='') as output_file:
+        writer = csv.writer(output_file)
+        writer.writerow(["Predicate", "EvaluationStrategy", "TimeInMs", "ResultSize", "PipelineRuns", "TotalTupleCount",
+                         "MaxTupleCount", "QueryCausingWork"])
+        for predicate in get_predicate_statistics(events):
+            writer.writerow([predicate["name"], predicate["strategy"], predicate["millis"], predicate["result_size"],
+                             predicate["pipeline_runs"], predicate["total_tuples"], predicate["max_tuples"],
+                             predicate["query_causing_work"] or ""])
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog='summarize_evaluator_log', description=help_statement)
+    parser.add_argument('log_summary', type=Path,
+                        help='The evaluator log summary produced by `codeql generate log-summary`.')
+    parser.add_argument('--queries-csv', type=Path, required=True,
+                        help='The CSV file to write the time of each query to.')
+    parser.add_argument('--predicates-csv', type=Path, required=True,
+                        help='The CSV file to write the statistics of each predicate to.')
+    args = parser.parse_args()
+
+    if not args.log_summary.exists():
+        print(f"The evaluator log summary {args.log_summary} does not exist.", file=sys.stderr)
+        sys.exit(1)
+
+    events = list(iter_evaluator_log_events(args.log_summary))
+    write_queries_csv(events, args.queries_csv)
+    write_predicates_csv(events, args.predicates_csv)
+
+
+if __name__ == '__main__':
+    main()
@@ -1,43 +1,52 @@
 import diagnostics
 import deviations
 import guideline_recategorizations
+import report_engine
 from pathlib import Path
 import sys
 import utils
 
 help_statement = """
-Usage: {script_name} database-dir sarif-results-file output_directory
+Usage: {script_name} [--preserve-cache] database-dir sarif-results-file output_directory
 
 A tool for producing a number of analysis reports for the given analysis.
+
+Options:
+  --preserve-cache  Do not clean up the evaluation cache of the database, unless it was
+                    produced by a different CodeQL CLI, database scheme or query pack version,
+                    and reuse the query results already stored in the database.
 """
 
 if (len(sys.argv) == 2 and sys.argv[1] == "--help"):
     print(help_statement.format(script_name=sys.argv[0]))
     sys.exit(0)
 
-if not len(sys.argv) == 4:
+preserve_cache = "--preserve-cache" in sys.argv[1:]
+arguments = [arg for arg in sys.argv[1:] if arg != "--preserve-cache"]
+
+if not len(arguments) == 3:
     print("Error: incorrect number of arguments", file=sys.stderr)
     print("Usage: " +
-          sys.argv[0] + " database-dir sarif-results-file output_directory", file=sys.stderr)
+          sys.argv[0] + " [--preserve-cache] database-dir sarif-results-file output_directory", file=sys.stderr)
     sys.exit(1)
 
 repo_root = Path(__file__).parent.parent.parent
 
-database_path = Path(sys.argv[1])
+database_path = Path(arguments[0])
 # Verify that the database exists
 if not database_path.exists():
     print(
         f"Error: database { database_path } does not exist.", file=sys.stderr)
     sys.exit(1)
 
-sarif_results_file_path = Path(sys.argv[2])
+sarif_results_file_path = Path(arguments[1])
 # Verify that the SARIF file exists
 if not sarif_results_file_path.exists():
     print(
         f"Error: SARIF file at { sarif_results_file_path } does not exist.", file=sys.stderr)
     sys.exit(1)
 
-output_directory = Path(sys.argv[3])
+output_directory = Path(arguments[2])
 if output_directory.exists():
     print(
         f"Error: Output directory at { output_directory } already exists.", file=sys.stderr)
@@ -46,15 +55,25 @@ if output_directory.exists():
 # Create the output directory
 output_directory.mkdir(parents=True)
 
-# Run some queries over the database to gather diagnostics
-diagnostics_results = diagnostics.DiagnosticsSummary(database_path, repo_root)
+# Run the queries of all reports over the database in a single pass
+engine = report_engine.ReportEngine(database_path, repo_root, preserve_cache)
+report_results = engine.run()
+
+# Gather the diagnostics from the query results
+diagnostics_results = diagnostics.DiagnosticsSummary(
+    database_path, repo_root, codeql_summary=engine.codeql_summary, results=report_results)
 # Generate a diagnostics result file
 diagnostics.generate_diagnostics_file(output_directory, diagnostics_results)
 
+deviations_results = deviations.DeviationsSummary(
+    database_path, repo_root, codeql_summary=engine.codeql_summary, results=report_results)
 deviations.generate_deviations_report(
-    database_path, repo_root, output_directory)
+    database_path, repo_root, output_directory, deviations_summary=deviations_results)
 
-guideline_recategorizations.generate_guideline_recategorizations_report(database_path, repo_root, output_directory)
+guideline_recategorizations_results = guideline_recategorizations.GuidelineRecategorizationsSummary(
+    database_path, repo_root, codeql_summary=engine.codeql_summary, results=report_results)
+guideline_recategorizations.generate_guideline_recategorizations_report(
+    database_path, repo_root, output_directory, guideline_recategorizations_summary=guideline_recategorizations_results)
 
 # Load the SARIF file and generate a results summary
 sarif_results_summary = utils.CodingStandardsResultSummary(
@@ -2,7 +2,8 @@ import pytest
 from pathlib import Path
 import sys
 from guideline_recategorizations import generate_guideline_recategorizations_report
-from deviations import generate_deviations_report
+from deviations import generate_deviations_report, DeviationsSummary
+from report_engine import ReportEngine
 
 script_path = Path(__file__)
 # Add the shared modules to the path so we can import them.
@@ -59,4 +60,31 @@ def test_deviations_report(tmp_path):
     expected = expected.replace("$codeql-version$", codeql.version).replace("$database-path$", str(db_path))
     actual = (tmp_path / "deviations_report.md").read_text()
 
-    assert(expected == actual)
\ No newline at end of file
+    assert(expected == actual)
+
+def test_deviations_report_from_report_engine(tmp_path):
+
+    db_path = tmp_path / 'test-db'
+    src_root = TEST_DATA_DIR / 'deviations'
+    codeql = CodeQL()
+
+    compile_src_command = "clang -fsyntax-only test.cpp"
+    index_coding_standards_config_command = f"python3 {SCRIPTS_DIR}/configuration/process_coding_standards_config.py"
+
+    try:
+        codeql.create_database(src_root, 'cpp', db_path, compile_src_command, index_coding_standards_config_command)
+    except CodeQLError as err:
+        print(err.stdout)
+        print(err.stderr)
+        raise err
+
+    engine = ReportEngine(db_path, REPO_ROOT)
+    results = engine.run()
+    deviations_summary = DeviationsSummary(db_path, REPO_ROOT, codeql_summary=engine.codeql_summary, results=results)
+    generate_deviations_report(db_path, REPO_ROOT, tmp_path, deviations_summary=deviations_summary)
+
+    expected = (TEST_DATA_DIR / 'deviations' / 'deviations_report.md.expected').read_text()
+    expected = expected.replace("$codeql-version$", codeql.version).replace("$database-path$", str(db_path))
+    actual = (tmp_path / "deviations_report.md").read_text()
+
+    assert(expected == actual)
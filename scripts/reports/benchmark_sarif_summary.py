@@ -0,0 +1,111 @@
+import argparse
+import json
+from pathlib import Path
+import random
+import resource
+import sys
+import tempfile
+import time
+import utils
+
+help_statement = """
+Benchmark the creation of a results summary from a synthetic SARIF file, reporting the elapsed time and the
+peak memory used. The synthetic SARIF file follows the structure of a CodeQL analysis with the Coding Standards
+queries, and is generated in a temporary directory unless an output path is specified.
+"""
+
+
+def generate_synthetic_sarif(output_path, number_of_results, number_of_rules, number_of_files, seed=0):
+    """Write a SARIF file with the given number of results, spread over the given number of rules and files."""
+    randomizer = random.Random(seed)
+    rules = []
+    for rule_index in range(number_of_rules):
+        rules.append({
+            "id": f"cpp/autosar/synthetic-rule-{rule_index}",
+            "name": f"cpp/autosar/synthetic-rule-{rule_index}",
+            "properties": {
+                "tags": [
+                    f"external/autosar/id/a{rule_index // 100}-{rule_index % 100}-1",
+                    "external/autosar/obligation/" + ("required" if rule_index % 3 else "advisory")
+                ]
+            }
+        })
+    tool = {
+        "driver": {
+            "name": "CodeQL",
+            "semanticVersion": "0.0.0",
+            "rules": rules
+        },
+        "extensions": [{"name": "codeql/autosar-cpp-coding-standards", "semanticVersion": "0.0.0"}]
+    }
+
+    with open(output_path, "w") as sarif_file:
+        sarif_file.write(
+            '{"$schema":"https://json.schemastore.org/sarif-2.1.0.json","version":"2.1.0","runs":[{"tool":')
+        json.dump(tool, sarif_file)
+        sarif_file.write(',"results":[')
+        for result_index in range(number_of_results):
+            if result_index > 0:
+                sarif_file.write(',')
+            result = {
+                "ruleId": f"cpp/autosar/synthetic-rule-{randomizer.randrange(number_of_rules)}",
+                "message": {"text": "Synthetic result " + "x" * randomizer.randrange(64, 512)},
+                "locations": [{
+                    "physicalLocation": {
+                        "artifactLocation": {"uri": f"src/synthetic/file{randomizer.randrange(number_of_files)}.cpp"},
+                        "region": {"startLine": randomizer.randrange(1, 5000), "startColumn": 1, "endColumn": 10}
+                    }
+                }],
+                "partialFingerprints": {"primaryLocationLineHash": f"{randomizer.getrandbits(64):016x}:1"}
+            }
+            if randomizer.random() < 0.05:
+                result["suppressions"] = [{"kind": "inSource"}]
+            json.dump(result, sarif_file)
+        sarif_file.write('],"artifacts":[')
+        sarif_file.write(','.join(json.dumps(
+            {"location": {"uri": f"src/synthetic/file{file_index}.cpp"}}) for file_index in range(number_of_files)))
+        sarif_file.write(']}]}')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog='benchmark_sarif_summary', description=help_statement)
+    parser.add_argument('--results', type=int, default=5_000_000,
+                        help='The number of results in the synthetic SARIF file. The default produces a file of roughly 2GB.')
+    parser.add_argument('--rules', type=int, default=1000,
+                        help='The number of rules in the synthetic SARIF file.')
+    parser.add_argument('--files', type=int, default=20000,
+                        help='The number of distinct files reported in the synthetic SARIF file.')
+    parser.add_argument('--output', type=Path, required=False,
+                        help='Keep the synthetic SARIF file at this path, or reuse it if it already exists.')
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        sarif_path = args.output if args.output else Path(
+            temp_dir) / 'synthetic.sarif'
+        if not sarif_path.exists():
+            print(
+                f"Generating synthetic SARIF file with {args.results} results at {sarif_path}...", file=sys.stderr)
+            generate_synthetic_sarif(
+                sarif_path, args.results, args.rules, args.files)
+        sarif_size = sarif_path.stat().st_size
+
+        start = time.perf_counter()
+        summary = utils.CodingStandardsResultSummary(sarif_path)
+        elapsed = time.perf_counter() - start
+        # ru_maxrss is reported in kilobytes on Linux and in bytes on macOS
+        peak_memory = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        if sys.platform == 'darwin':
+            peak_memory = peak_memory // 1024
+
+        total_results = sum(summary.file_result_count.values()) + \
+            sum(summary.file_deviation_count.values())
+        print(f"SARIF file size: {sarif_size / (1 << 20):.1f} MiB")
+        print(f"Results summarized: {total_results}")
+        print(f"Elapsed time: {elapsed:.1f} s")
+        print(f"Throughput: {sarif_size / (1 << 20) / elapsed:.1f} MiB/s")
+        print(f"Peak memory: {peak_memory / 1024:.1f} MiB")
+
+
+if __name__ == '__main__':
+    main()
@@ -15,64 +15,87 @@ if __name__ == '__main__':
     failure("Error: this Python module does not support standalone execution!")
 
 
+def get_deviations_queries(repo_root):
+    """Return the deviation queries, and the options required to decode their results."""
+    deviations_path = repo_root.joinpath(
+        'cpp', 'common', 'src', 'codingstandards', 'cpp', 'deviations')
+
+    queries = ['ListDeviationRecords.ql', 'InvalidDeviationRecords.ql',
+               'ListDeviationPermits.ql', 'InvalidDeviationPermits.ql']
+
+    query_options = []
+    for query in queries:
+        if query.startswith("List"):
+            query_options.append(
+                (deviations_path.joinpath(query), {'no_titles': True}))
+        elif query.startswith("Invalid"):
+            query_options.append((deviations_path.joinpath(query), {
+                                 'entities': 'url,string', 'no_titles': True}))
+        else:
+            failure(
+                f"Error: Don't know how to decode query results for {query}")
+    return query_options
+
+
 class DeviationsSummary:
-    def __init__(self, database_path, repo_root):
+    def __init__(self, database_path, repo_root, preserve_cache=False, codeql_summary=None, results=None):
+        """
+        Create a deviations summary for the database. If `results` is provided, it must map each of the
+        deviation queries to their decoded results, and the queries are not run again.
+        """
         if isinstance(database_path, str):
             database_path = Path(database_path)
         if isinstance(repo_root, str):
             repo_root = Path(repo_root)
 
         self.database_path = database_path
-        try:
-            self.codeql_summary = CodeQLValidationSummary()
-        except CodeQLError as err:
-            failure("Error: Could not initialize CodeQL", err)
-
-        deviations_path = repo_root.joinpath(
-            'cpp', 'common', 'src', 'codingstandards', 'cpp', 'deviations')
-
-        queries = ['ListDeviationRecords.ql', 'InvalidDeviationRecords.ql',
-                   'ListDeviationPermits.ql', 'InvalidDeviationPermits.ql']
+        if codeql_summary:
+            self.codeql_summary = codeql_summary
+        else:
+            try:
+                self.codeql_summary = CodeQLValidationSummary()
+            except CodeQLError as err:
+                failure("Error: Could not initialize CodeQL", err)
 
-        query_paths = map(deviations_path.joinpath, queries)
+        queries = get_deviations_queries(repo_root)
 
         try:
-            # Cleanup database cache to prevent potential cache issue
-            self.codeql_summary.codeql.cleanup(database_path, mode="brutal")
-            # Get a list of deviations
-            print("Running the deviation query...")
-            self.codeql_summary.codeql.run_queries(
-                database_path, *query_paths, no_rerun=True)
+            if results is None:
+                query_paths = [query for query, _ in queries]
+                # Get a list of deviations
+                print("Running the deviation query...")
+                if preserve_cache:
+                    # Only invalidate a stale cache, and reuse existing results
+                    self.codeql_summary.codeql.run_queries_reusing_cache(
+                        database_path, *query_paths, no_rerun=True)
+                else:
+                    # Cleanup database cache to prevent potential cache issue
+                    self.codeql_summary.codeql.cleanup(
+                        database_path, mode="brutal")
+                    self.codeql_summary.codeql.run_queries(
+                        database_path, *query_paths, no_rerun=True)
 
-            print("Decoding deviation query results")
+                print("Decoding deviation query results")
+                results = {query: self.codeql_summary.codeql.decode_results(
+                    database_path, query, **options) for query, options in queries}
 
             def camel_to_underscore(s):
                 return re.sub(
                     r'([A-Z])', lambda m: f"_{m.group(1).lower()}", s)
-            for query in queries:
-                if query.startswith("List"):
-                    decoded_results = self.codeql_summary.codeql.decode_results(
-                        database_path, deviations_path.joinpath(query), no_titles=True)
-                    key = camel_to_underscore(
-                        query).removeprefix('_list_').removesuffix('.ql')
-                    setattr(self, key, decoded_results)
-                elif query.startswith("Invalid"):
-                    decoded_results = self.codeql_summary.codeql.decode_results(
-                        database_path, deviations_path.joinpath(query), entities='url,string', no_titles=True)
-                    key = camel_to_underscore(
-                        query).removeprefix('_').removesuffix('.ql')
-                    setattr(self, key, decoded_results)
-                else:
-                    failure(
-                        f"Error: Don't know how to decode query results for {query}")
+            for query, _ in queries:
+                key = camel_to_underscore(query.name).removeprefix(
+                    '_list_').removeprefix('_').removesuffix('.ql')
+                setattr(self, key, results[query])
         except CodeQLError as err:
             failure("Error: Failed to run deviation query", err)
 
 
-def generate_deviations_report(database_path, repo_root, output_directory):
+def generate_deviations_report(database_path, repo_root, output_directory, preserve_cache=False, deviations_summary=None):
     """Print a "deviations report"."""
 
-    deviations_summary = DeviationsSummary(database_path, repo_root)
+    if not deviations_summary:
+        deviations_summary = DeviationsSummary(
+            database_path, repo_root, preserve_cache)
     deviations_report_path = output_directory.joinpath(
         "deviations_report.md")
     try:
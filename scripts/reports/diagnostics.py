@@ -9,8 +9,23 @@ script_path = Path(__file__)
 sys.path.append(str(script_path.parent.parent / 'shared'))
 from codeql import CodeQLError
 
+def get_diagnostics_queries(repo_root):
+    """Return the diagnostic queries, and the options required to decode their results."""
+    report_queries_path = repo_root.joinpath('cpp', 'report', 'src', 'Diagnostics')
+    return [
+        (report_queries_path.joinpath('ExtractionErrors.ql'),
+         {'entities': 'string,url', 'no_titles': True}),
+        (report_queries_path.joinpath('SuccessfullyExtractedFiles.ql'),
+         {'entities': 'string,url', 'no_titles': True})
+    ]
+
+
 class DiagnosticsSummary:
-    def __init__(self, database_path, repo_root):
+    def __init__(self, database_path, repo_root, preserve_cache=False, codeql_summary=None, results=None):
+        """
+        Create a diagnostics summary for the database. If `results` is provided, it must map each of the
+        diagnostic queries to their decoded results, and the queries are not run again.
+        """
         if isinstance(database_path, str):
             database_path = Path(database_path)
         if isinstance(repo_root, str):
@@ -20,37 +35,38 @@ class DiagnosticsSummary:
         self.database_path = database_path.resolve()
         repo_root = repo_root.resolve()
 
-        try:
-            self.codeql_summary = CodeQLValidationSummary()
-        except CodeQLError as err:
-            failure("Error: Unable to retrieve CodeQL validation summary", err)
+        if codeql_summary:
+            self.codeql_summary = codeql_summary
+        else:
+            try:
+                self.codeql_summary = CodeQLValidationSummary()
+            except CodeQLError as err:
+                failure("Error: Unable to retrieve CodeQL validation summary", err)
 
-        extraction_error_query_path = Path(
-            'Diagnostics', 'ExtractionErrors.ql')
-        successfully_extracted_files_path = Path(
-            'Diagnostics', 'SuccessfullyExtractedFiles.ql')
-
-        queries = [
-
-            repo_root.joinpath('cpp', 'report', 'src',
-                               extraction_error_query_path),
-            repo_root.joinpath('cpp', 'report', 'src',
-                               successfully_extracted_files_path)
-        ]
+        queries = get_diagnostics_queries(repo_root)
 
         try:
-            # Cleanup database cache to prevent potential cache issue
-            self.codeql_summary.codeql.cleanup(database_path, mode="brutal")
-            # Run all the diagnostics over the database
-            print("Running the diagnostic queries...")
-            self.codeql_summary.codeql.run_queries(
-                database_path, *queries, no_rerun=True)
+            if results is None:
+                query_paths = [query for query, _ in queries]
+                # Run all the diagnostics over the database
+                print("Running the diagnostic queries...")
+                if preserve_cache:
+                    # Only invalidate a stale cache, and reuse existing results
+                    self.codeql_summary.codeql.run_queries_reusing_cache(
+                        database_path, *query_paths, no_rerun=True)
+                else:
+                    # Cleanup database cache to prevent potential cache issue
+                    self.codeql_summary.codeql.cleanup(
+                        database_path, mode="brutal")
+                    self.codeql_summary.codeql.run_queries(
+                        database_path, *query_paths, no_rerun=True)
+
+                print("Decoding diagnostic query results")
+                results = {query: self.codeql_summary.codeql.decode_results(
+                    database_path, query, **options) for query, options in queries}
 
-            print("Decoding diagnostic query results")
-            self.extraction_errors = self.codeql_summary.codeql.decode_results(
-                database_path, queries[0], entities="string,url", no_titles=True)
-            self.successfully_extracted_files = self.codeql_summary.codeql.decode_results(
-                database_path, queries[1], entities="string,url", no_titles=True)
+            self.extraction_errors = results[queries[0][0]]
+            self.successfully_extracted_files = results[queries[1][0]]
         except CodeQLError as err:
             failure("Error: Could not run diagnostic queries", err)
 
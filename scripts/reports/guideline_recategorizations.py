@@ -14,56 +14,72 @@ if __name__ == '__main__':
     failure("Error: this Python module does not support standalone execution!")
 
 
+def get_guideline_recategorizations_queries(repo_root):
+    """Return the guideline recategorization queries, and the options required to decode their results."""
+    guideline_recategorizations_path = repo_root.joinpath(
+        'cpp', 'common', 'src', 'codingstandards', 'cpp', 'guideline_recategorizations')
+    return [
+        (guideline_recategorizations_path.joinpath(
+            'ListGuidelineRecategorizations.ql'), {'no_titles': True}),
+        (guideline_recategorizations_path.joinpath('InvalidGuidelineRecategorizations.ql'),
+         {'entities': 'url,string', 'no_titles': True})
+    ]
+
+
 class GuidelineRecategorizationsSummary:
-    def __init__(self, database_path, repo_root):
+    def __init__(self, database_path, repo_root, preserve_cache=False, codeql_summary=None, results=None):
+        """
+        Create a guideline recategorizations summary for the database. If `results` is provided, it must map
+        each of the guideline recategorization queries to their decoded results, and the queries are not run again.
+        """
         if isinstance(database_path, str):
             database_path = Path(database_path)
         if isinstance(repo_root, str):
             repo_root = Path(repo_root)
 
         self.database_path = database_path
-        try:
-            self.codeql_summary = CodeQLValidationSummary()
-        except CodeQLError as err:
-            failure("Error: Could not initialize CodeQL", err)
+        if codeql_summary:
+            self.codeql_summary = codeql_summary
+        else:
+            try:
+                self.codeql_summary = CodeQLValidationSummary()
+            except CodeQLError as err:
+                failure("Error: Could not initialize CodeQL", err)
 
-        guideline_recategorizations_path = repo_root.joinpath(
-            'cpp', 'common', 'src', 'codingstandards', 'cpp', 'guideline_recategorizations')
-
-        queries = ['ListGuidelineRecategorizations.ql', 'InvalidGuidelineRecategorizations.ql']
-
-        query_paths = map(guideline_recategorizations_path.joinpath, queries)
+        queries = get_guideline_recategorizations_queries(repo_root)
 
         try:
-            # Cleanup database cache to prevent potential cache issue
-            self.codeql_summary.codeql.cleanup(database_path, mode="brutal")
-            # Get a list of guideline recategorizations
-            print("Running the guideline recategorizations queries...")
-            self.codeql_summary.codeql.run_queries(
-                database_path, *query_paths, no_rerun=True)
+            if results is None:
+                query_paths = [query for query, _ in queries]
+                # Get a list of guideline recategorizations
+                print("Running the guideline recategorizations queries...")
+                if preserve_cache:
+                    # Only invalidate a stale cache, and reuse existing results
+                    self.codeql_summary.codeql.run_queries_reusing_cache(
+                        database_path, *query_paths, no_rerun=True)
+                else:
+                    # Cleanup database cache to prevent potential cache issue
+                    self.codeql_summary.codeql.cleanup(
+                        database_path, mode="brutal")
+                    self.codeql_summary.codeql.run_queries(
+                        database_path, *query_paths, no_rerun=True)
 
-            print("Decoding guideline recategorizations queries results")
+                print("Decoding guideline recategorizations queries results")
+                results = {query: self.codeql_summary.codeql.decode_results(
+                    database_path, query, **options) for query, options in queries}
 
-            for query in queries:
-                if query.startswith("List"):
-                    decoded_results = self.codeql_summary.codeql.decode_results(
-                        database_path, guideline_recategorizations_path.joinpath(query), no_titles=True)
-                    self.guideline_recategorizations = decoded_results
-                elif query.startswith("Invalid"):
-                    decoded_results = self.codeql_summary.codeql.decode_results(
-                        database_path, guideline_recategorizations_path.joinpath(query), entities='url,string', no_titles=True)
-                    self.invalid_guideline_recategorizations = decoded_results
-                else:
-                    failure(
-                        f"Error: Don't know how to decode query results for {query}")
+            self.guideline_recategorizations = results[queries[0][0]]
+            self.invalid_guideline_recategorizations = results[queries[1][0]]
         except CodeQLError as err:
             failure("Error: Failed to run guideline recategorizations queries", err)
 
 
-def generate_guideline_recategorizations_report(database_path, repo_root, output_directory):
+def generate_guideline_recategorizations_report(database_path, repo_root, output_directory, preserve_cache=False, guideline_recategorizations_summary=None):
     """Print a "guideline recategorizations report"."""
 
-    guideline_recategorizations_summary = GuidelineRecategorizationsSummary(database_path, repo_root)
+    if not guideline_recategorizations_summary:
+        guideline_recategorizations_summary = GuidelineRecategorizationsSummary(
+            database_path, repo_root, preserve_cache)
     guideline_recategorizations_report_path = output_directory.joinpath(
         "guideline_recategorizations_report.md")
     try:
@@ -0,0 +1,61 @@
+from pathlib import Path
+from codeqlvalidation import CodeQLValidationSummary
+from diagnostics import get_diagnostics_queries
+from deviations import get_deviations_queries
+from guideline_recategorizations import get_guideline_recategorizations_queries
+from error import failure
+import sys
+
+script_path = Path(__file__)
+# Add the shared modules to the path so we can import them.
+sys.path.append(str(script_path.parent.parent / 'shared'))
+from codeql import CodeQLError
+
+
+if __name__ == '__main__':
+    failure("Error: this Python module does not support standalone execution!")
+
+
+class ReportEngine:
+    """
+    Runs the queries of all the analysis reports in a single evaluator invocation, and decodes their results in parallel.
+    """
+
+    def __init__(self, database_path, repo_root, preserve_cache=False):
+        if isinstance(database_path, str):
+            database_path = Path(database_path)
+        if isinstance(repo_root, str):
+            repo_root = Path(repo_root)
+
+        self.database_path = database_path
+        self.repo_root = repo_root.resolve()
+        self.preserve_cache = preserve_cache
+
+        try:
+            self.codeql_summary = CodeQLValidationSummary()
+        except CodeQLError as err:
+            failure("Error: Unable to retrieve CodeQL validation summary", err)
+
+        self.queries = get_diagnostics_queries(self.repo_root) + get_deviations_queries(
+            self.repo_root) + get_guideline_recategorizations_queries(self.repo_root)
+
+    def run(self):
+        """Return a mapping from each report query to its decoded results."""
+        codeql = self.codeql_summary.codeql
+        query_paths = [query for query, _ in self.queries]
+        try:
+            print("Running the report queries...")
+            if self.preserve_cache:
+                # Only invalidate a stale cache, and reuse existing results
+                codeql.run_queries_reusing_cache(
+                    self.database_path, *query_paths, no_rerun=True)
+            else:
+                # Cleanup database cache to prevent potential cache issue
+                codeql.cleanup(self.database_path, mode="brutal")
+                codeql.run_queries(self.database_path,
+                                   *query_paths, no_rerun=True)
+
+            print("Decoding report query results")
+            return codeql.decode_results_in_parallel(self.database_path, self.queries)
+        except CodeQLError as err:
+            failure("Error: Could not run report queries", err)
@@ -0,0 +1,176 @@
+import json
+from json.decoder import JSONDecodeError
+import re
+
+
+class SarifStreamError(Exception):
+    def __init__(self, reason):
+        self.reason = reason
+
+    def __str__(self):
+        return repr(self.reason)
+
+
+class JsonStream:
+    """
+    An incremental reader for a JSON document.
+
+    Only the values that are explicitly requested with `read_value` are materialized. Arrays and objects can be
+    traversed element by element with `iter_array` and `iter_object`, and values that are not required are skipped
+    without being kept in memory, so that the memory used is bounded by the largest value read rather than the size
+    of the document.
+    """
+
+    WHITESPACE_RE = re.compile(r"[ \t\n\r]*")
+    NUMBER_START_RE = re.compile(r"[-0-9]")
+    NUMBER_END_RE = re.compile(r"[,\]} \t\n\r]")
+
+    def __init__(self, file, chunk_size=1 << 20):
+        self.file = file
+        self.chunk_size = chunk_size
+        self.buffer = ""
+        self.position = 0
+        self.eof = False
+        self.decoder = json.JSONDecoder()
+
+    def _fill(self, size=None):
+        """
+        Read the next `size` characters of the file, or the next chunk by default, into the buffer, returning `False`
+        at the end of the file.
+        """
+        if self.eof:
+            return False
+        chunk = self.file.read(size or self.chunk_size)
+        if not chunk:
+            self.eof = True
+            return False
+        # Discard the consumed part of the buffer, so that the buffer does not grow with the file.
+        self.buffer = self.buffer[self.position:] + chunk
+        self.position = 0
+        return True
+
+    def _skip_whitespace(self):
+        while True:
+            self.position = self.WHITESPACE_RE.match(
+                self.buffer, self.position).end()
+            if self.position < len(self.buffer) or not self._fill():
+                return
+
+    def peek(self):
+        """Return the next non-whitespace character, or `None` at the end of the document."""
+        self._skip_whitespace()
+        if self.position < len(self.buffer):
+            return self.buffer[self.position]
+        return None
+
+    def expect(self, character):
+        actual = self.peek()
+        if actual != character:
+            raise SarifStreamError(
+                f"Expected '{character}' but found '{actual}' in JSON document")
+        self.position += 1
+
+    def read_value(self):
+        """Decode and return the next JSON value."""
+        self._skip_whitespace()
+        while True:
+            try:
+                value, end = self.decoder.raw_decode(
+                    self.buffer, self.position)
+                # A number is only complete if it is followed by a delimiter, as it may continue in the next chunk.
+                if self.eof or not self.NUMBER_START_RE.match(self.buffer, self.position) or \
+                        self.NUMBER_END_RE.match(self.buffer, end):
+                    self.position = end
+                    return value
+            except JSONDecodeError as err:
+                if self.eof:
+                    raise SarifStreamError(
+                        f"Invalid JSON document: {err.msg}")
+            # The value may be incomplete, so read more of the file and try again. The amount read grows with the
+            # size of the incomplete value, so that decoding a large value is not quadratic in its size.
+            self._fill(max(self.chunk_size, len(self.buffer) - self.position))
+
+    def skip_value(self):
+        """Skip the next JSON value, descending into arrays and objects so that they are never fully loaded."""
+        next_character = self.peek()
+        if next_character == '[':
+            for _ in self.iter_array():
+                self.skip_value()
+        elif next_character == '{':
+            for _ in self.iter_object():
+                self.skip_value()
+        else:
+            self.read_value()
+
+    def iter_array(self):
+        """
+        Iterate over an array, yielding the index of each element. The caller must consume each element, with
+        `read_value`, `skip_value` or a nested iteration, before requesting the next one.
+        """
+        self.expect('[')
+        if self.peek() == ']':
+            self.position += 1
+            return
+        index = 0
+        while True:
+            yield index
+            index += 1
+            next_character = self.peek()
+            self.position += 1
+            if next_character == ']':
+                return
+            if next_character != ',':
+                raise SarifStreamError(
+                    f"Expected ',' or ']' but found '{next_character}' in JSON array")
+
+    def iter_object(self):
+        """
+        Iterate over an object, yielding each key. The caller must consume the value of each key, with
+        `read_value`, `skip_value` or a nested iteration, before requesting the next one.
+        """
+        self.expect('{')
+        if self.peek() == '}':
+            self.position += 1
+            return
+        while True:
+            key = self.read_value()
+            if not isinstance(key, str):
+                raise SarifStreamError(
+                    f"Expected a string key in JSON object, but found {key}")
+            self.expect(':')
+            yield key
+            next_character = self.peek()
+            self.position += 1
+            if next_character == '}':
+                return
+            if next_character != ',':
+                raise SarifStreamError(
+                    f"Expected ',' or '}}' but found '{next_character}' in JSON object")
+
+
+def stream_sarif(file, result_callback, chunk_size=1 << 20):
+    """
+    Stream the SARIF document in `file`, calling `result_callback(run_index, result)` for each result of each run
+    as it is read. Returns a list with the `tool` object of each run.
+
+    Only the `tool` objects and a single result at a time are kept in memory. All other properties of the runs, such
+    as the artifacts, are skipped. Results are reported in the order they appear in the file, which may be before the
+    `tool` object of the run has been read.
+    """
+    stream = JsonStream(file, chunk_size)
+    tools = []
+    for key in stream.iter_object():
+        if key != "runs":
+            stream.skip_value()
+            continue
+        for run_index in stream.iter_array():
+            tools.append(None)
+            for run_key in stream.iter_object():
+                if run_key == "tool":
+                    tools[run_index] = stream.read_value()
+                elif run_key == "results":
+                    for _ in stream.iter_array():
+                        result_callback(run_index, stream.read_value())
+                else:
+                    stream.skip_value()
+    return tools
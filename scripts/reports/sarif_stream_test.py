@@ -0,0 +1,77 @@
+import io
+import json
+import pytest
+from sarif_stream import JsonStream, SarifStreamError, stream_sarif
+from utils import CodingStandardsResultSummary
+from benchmark_sarif_summary import generate_synthetic_sarif
+
+
+def test_json_stream_across_chunk_boundaries():
+    document = {"a": [1, 22, 333, {"b": "a string with \\\"escapes\\\""}, [], {}], "c": 1.5e10, "d": [True, False, None]}
+    stream = JsonStream(io.StringIO(json.dumps(document, indent=2)), chunk_size=3)
+    assert(stream.read_value() == document)
+
+
+@pytest.mark.parametrize("chunk_size", [1, 2, 3, 5, 7, 11])
+def test_json_stream_numbers_across_chunk_boundaries(chunk_size):
+    document = [1.5e10, 2.25, -3, 0, -0.125, 12345678901234567890, 6.02e-23, 1e5, 88.5]
+    for text in [json.dumps(document), json.dumps(document, indent=2)]:
+        stream = JsonStream(io.StringIO(text), chunk_size=chunk_size)
+        values = []
+        for _ in stream.iter_array():
+            values.append(stream.read_value())
+        assert(values == document)
+    stream = JsonStream(io.StringIO("1.5e10"), chunk_size=chunk_size)
+    assert(stream.read_value() == 1.5e10)
+
+
+def test_json_stream_large_value_read_in_growing_chunks():
+    class CountingReader(io.StringIO):
+        reads = 0
+
+        def read(self, size=-1):
+            self.reads += 1
+            return super().read(size)
+
+    value = "x" * 100000
+    reader = CountingReader(json.dumps([value, 1]))
+    stream = JsonStream(reader, chunk_size=10)
+    assert(stream.read_value() == [value, 1])
+    # The reads grow with the size of the incomplete value, rather than reading one chunk at a time.
+    assert(reader.reads < 30)
+
+
+def test_stream_sarif_skips_other_properties():
+    document = {
+        "version": "2.1.0",
+        "runs": [{
+            "artifacts": [{"location": {"uri": "a.cpp"}}],
+            "results": [{"ruleId": "r1"}, {"ruleId": "r2"}],
+            "tool": {"driver": {"name": "CodeQL"}}
+        }]
+    }
+    results = []
+    tools = stream_sarif(io.StringIO(json.dumps(document)),
+                         lambda run_index, result: results.append((run_index, result)), chunk_size=5)
+    assert(tools == [{"driver": {"name": "CodeQL"}}])
+    assert(results == [(0, {"ruleId": "r1"}), (0, {"ruleId": "r2"})])
+
+
+def test_stream_sarif_invalid_document():
+    with pytest.raises(SarifStreamError):
+        stream_sarif(io.StringIO('{"runs": [{"results": [{"ruleId": }]}]}'), lambda run_index, result: None)
+
+
+def test_result_summary_matches_loaded_sarif(tmp_path):
+    sarif_path = tmp_path / 'synthetic.sarif'
+    generate_synthetic_sarif(sarif_path, 1000, 20, 10)
+
+    summary = CodingStandardsResultSummary(sarif_path)
+
+    sarif = json.loads(sarif_path.read_text())
+    results = sarif["runs"][0]["results"]
+    deviated_results = [result for result in results if result.get("suppressions")]
+    assert(sum(summary.file_result_count.values()) == len(results) - len(deviated_results))
+    assert(sum(summary.file_deviation_count.values()) == len(deviated_results))
+    assert(sum(count for counts in summary.guideline_violation_count.values() for count in counts.values()) == len(results) - len(deviated_results))
+    assert(sum(count for counts in summary.guideline_deviation_count.values() for count in counts.values()) == len(deviated_results))
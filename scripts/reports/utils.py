@@ -3,6 +3,7 @@ from contextlib import redirect_stdout
 import json
 from pathlib import Path
 import re
+from sarif_stream import stream_sarif, SarifStreamError
 import sys
 
 REPO_ROOT = Path(__file__).parent.parent.parent
@@ -51,19 +52,81 @@ def load_sarif(sarif_results_file_path):
     # TODO Warn if using a results file from a different version of the Coding Standards pack
 
 
+def stream_sarif_results(sarif_results_file_path, result_callback):
+    """
+    Read the SARIF file at sarif_results_file_path incrementally, calling result_callback(run_index, result) for each
+    result. Returns the list of tool objects, one per run. Unlike load_sarif, the memory used does not depend on the
+    number of results in the file.
+    """
+    print(f"Streaming SARIF file...", file=sys.stderr)
+    try:
+        sarif_results_file = open(sarif_results_file_path, "r")
+    except PermissionError:
+        print("Error: No permission to read the SARIF results file located at '" +
+              str(sarif_results_file_path) + "'", file=sys.stderr)
+        sys.exit(1)
+    else:
+        with sarif_results_file:
+            try:
+                tools = stream_sarif(sarif_results_file, result_callback)
+            except SarifStreamError as err:
+                print(
+                    f"Error: Could not read the SARIF results file located at '{ sarif_results_file_path }': { err.reason }", file=sys.stderr)
+                sys.exit(1)
+    print(f"SARIF file streamed", file=sys.stderr)
+    return tools
+
+
+def get_result_file(result):
+    """Return the URI of the primary location of a SARIF result, or None if it has no location."""
+    for location in result.get("locations", []):
+        uri = location.get("physicalLocation", {}).get(
+            "artifactLocation", {}).get("uri")
+        if uri:
+            return uri
+    return None
+
+
 class CodingStandardsResultSummary:
     def __init__(self, sarif_results_file_path):
         """Create a results summary from the given SARIF path"""
-        sarif_results_json = load_sarif(sarif_results_file_path)
-        number_of_runs = len(sarif_results_json["runs"])
+        # Count the results per SARIF rule ID
+        sarif_rule_result_count = defaultdict(int)
+        # Count the deviations per SARIF rule ID
+        sarif_rule_deviation_count = defaultdict(int)
+        # Count the results and deviations per file
+        self.file_result_count = defaultdict(int)
+        self.file_deviation_count = defaultdict(int)
+
+        def count_result(run_index, result):
+            if run_index > 0:
+                # Reported as an error once the number of runs is known
+                return
+            sarif_rule_id = result["ruleId"]
+            result_file = get_result_file(result)
+            if "suppressions" in result and len(result['suppressions']) != 0:
+                sarif_rule_deviation_count[sarif_rule_id] += 1
+                if result_file:
+                    self.file_deviation_count[result_file] += 1
+            else:
+                sarif_rule_result_count[sarif_rule_id] += 1
+                if result_file:
+                    self.file_result_count[result_file] += 1
+
+        # Aggregate the results as they are read, rather than loading the whole SARIF file
+        tools = stream_sarif_results(sarif_results_file_path, count_result)
+        number_of_runs = len(tools)
         if not number_of_runs == 1:
             print(
                 f"Error: Expected a single SARIF run, but found { number_of_runs } runs.", file=sys.stderr)
             sys.exit(1)
-        run = sarif_results_json["runs"][0]
 
         # Identify the Coding Standard version numbers used
-        tool = run["tool"]
+        tool = tools[0]
+        if tool is None:
+            print(
+                f"Error: SARIF run does not specify the tool that produced it.", file=sys.stderr)
+            sys.exit(1)
         driver = tool["driver"]
         self.codeql_cli_version = driver["semanticVersion"]
         # Validate that this is, indeed, a CodeQL file
@@ -81,18 +144,6 @@ class CodingStandardsResultSummary:
                 if extension["name"].endswith(ending):
                     self.coding_standard_relevant_packs.append(extension)
 
-        # Count the results per SARIF rule ID
-        sarif_rule_result_count = defaultdict(int)
-        # Count the deviations per SARIF rule ID
-        sarif_rule_deviation_count = defaultdict(int)
-        results = run["results"]
-        for result in results:
-            sarif_rule_id = result["ruleId"]
-            if "suppressions" in result and len(result['suppressions']) != 0:
-                sarif_rule_deviation_count[sarif_rule_id] += 1
-            else:
-                sarif_rule_result_count[sarif_rule_id] += 1
-
         # The number of guidelines violated for each obligation level
         self.guidelines_violated_by_obligation = defaultdict(int)
         self.guidelines_compliant_by_obligation = defaultdict(int)
@@ -1,9 +1,12 @@
 import subprocess
 import json
+import sys
+from concurrent.futures import ThreadPoolExecutor
 from json.decoder import JSONDecodeError
 import tempfile
 from pathlib import Path
 import csv
+import hashlib
 import yaml
 from typing import *
 
@@ -91,12 +94,132 @@ class CodeQL():
         with qlpack_path.open() as f:
             return yaml.safe_load(f)
 
-    def decode_results(self, database_path: Path, query_path: Path, **options: str) -> List:
+    def resolve_bqrs_path(self, database_path: Path, query_path: Path) -> Path:
         qlpack_path = self.resolve_qlpack_path(query_path)
         qlpack = self.get_qlpack(qlpack_path)
         relative_query_path = query_path.relative_to(qlpack_path.parent)
-        bqrs_path = (database_path / "results" /
-                     qlpack['name'] / relative_query_path).with_suffix(".bqrs")
+        return (database_path / "results" /
+                qlpack['name'] / relative_query_path).with_suffix(".bqrs")
+
+    def has_results(self, database_path: Path, query_path: Path) -> bool:
+        return self.resolve_bqrs_path(database_path, query_path).exists()
+
+    def get_cache_fingerprint(self, database_path: Path, *queries: Path) -> Dict[str, Any]:
+        """
+        Compute a fingerprint of everything that can invalidate the evaluation cache of a database
+        for the given queries: the CodeQL CLI version, the database schemes and the versions and
+        lock files of the QL packs the queries belong to.
+        """
+        dbschemes = {}
+        for dbscheme_path in sorted(database_path.glob("db-*/*.dbscheme")):
+            dbschemes[str(dbscheme_path.relative_to(database_path))] = hashlib.sha256(
+                dbscheme_path.read_bytes()).hexdigest()
+
+        packs = {}
+        for query in queries:
+            qlpack_path = self.resolve_qlpack_path(query)
+            qlpack = self.get_qlpack(qlpack_path)
+            lock_file_path = qlpack_path.parent / 'codeql-pack.lock.yml'
+            lock_file_hash = hashlib.sha256(lock_file_path.read_bytes()).hexdigest(
+            ) if lock_file_path.exists() else None
+            packs[qlpack['name']] = {
+                'version': qlpack.get('version'), 'lock': lock_file_hash}
+
+        return {'codeql': self.version, 'dbschemes': dbschemes, 'packs': packs}
+
+    def cleanup_stale_cache(self, database_path: Path, *queries: Path) -> bool:
+        """
+        Cleanup the database cache only if it was populated by a different CodeQL CLI, database scheme or
+        QL pack version than the one used to evaluate the given queries. Returns `True` if the cache was
+        cleaned up.
+
+        The fingerprint of the last evaluation is recorded in the database directory. A database without a
+        recorded fingerprint is assumed to have been analyzed with the current tooling, so that the cache
+        built by a preceding `codeql database analyze` run is preserved.
+        """
+        if not database_path.exists():
+            raise CodeQLError(f"Database '{database_path}' not found!")
+
+        fingerprint_path = database_path / 'coding-standards-cache.json'
+        fingerprint = self.get_cache_fingerprint(database_path, *queries)
+
+        recorded_fingerprint = None
+        if fingerprint_path.exists():
+            try:
+                recorded_fingerprint = json.loads(fingerprint_path.read_text())
+            except JSONDecodeError:
+                recorded_fingerprint = {}
+        else:
+            print(f"No cache fingerprint recorded for database '{database_path}', assuming its cache and results "
+                  "were produced by the current CodeQL CLI and query packs.", file=sys.stderr)
+
+        is_stale = False
+        if recorded_fingerprint is not None:
+            if recorded_fingerprint.get('codeql') != fingerprint['codeql'] or recorded_fingerprint.get('dbschemes') != fingerprint['dbschemes']:
+                is_stale = True
+            else:
+                recorded_packs = recorded_fingerprint.get('packs', {})
+                is_stale = any(name in recorded_packs and recorded_packs[name] != pack
+                               for name, pack in fingerprint['packs'].items())
+                if not is_stale:
+                    # Keep track of the packs evaluated by earlier invocations, because their cache entries are retained.
+                    fingerprint['packs'] = {
+                        **recorded_packs, **fingerprint['packs']}
+            # The results recorded by earlier invocations are only kept if the cache is kept.
+            if not is_stale:
+                fingerprint['results'] = recorded_fingerprint.get('results', {})
+
+        if is_stale:
+            self.cleanup(database_path, mode="brutal")
+
+        fingerprint_path.write_text(json.dumps(fingerprint, indent=2))
+        return is_stale
+
+    def __get_results_fingerprint(self, fingerprint: Dict[str, Any], query: Path) -> Dict[str, Any]:
+        qlpack = self.get_qlpack(self.resolve_qlpack_path(query))
+        return {'codeql': fingerprint['codeql'], 'dbschemes': fingerprint['dbschemes'],
+                'pack': fingerprint['packs'][qlpack['name']]}
+
+    def run_queries_reusing_cache(self, database_path: Path, *queries: Path, **options: str) -> None:
+        """
+        Run the queries that do not yet have results in the database, after invalidating a stale
+        evaluation cache. Results are only reused if they were produced with the same CodeQL CLI, database
+        scheme and QL pack version, as recorded next to the cache fingerprint. Results in a database without a
+        recorded fingerprint, such as those produced by an earlier `codeql database analyze`, are assumed to have
+        been produced with the current tooling.
+        """
+        fingerprint_path = database_path / 'coding-standards-cache.json'
+        has_recorded_fingerprint = fingerprint_path.exists()
+        is_stale = self.cleanup_stale_cache(database_path, *queries)
+        fingerprint = json.loads(fingerprint_path.read_text())
+        recorded_results = fingerprint.setdefault('results', {})
+
+        pending_queries = []
+        for query in queries:
+            bqrs_path = self.resolve_bqrs_path(database_path, query)
+            results_key = bqrs_path.relative_to(database_path).as_posix()
+            results_fingerprint = self.__get_results_fingerprint(fingerprint, query)
+            if bqrs_path.exists() and not is_stale and (
+                    recorded_results.get(results_key) == results_fingerprint
+                    or not has_recorded_fingerprint and results_key not in recorded_results):
+                recorded_results[results_key] = results_fingerprint
+                continue
+            # The results were produced by different tooling or query packs, so they are discarded and re-computed.
+            if bqrs_path.exists():
+                bqrs_path.unlink()
+            recorded_results.pop(results_key, None)
+            pending_queries.append((query, results_key, results_fingerprint))
+
+        if len(pending_queries) > 0:
+            self.run_queries(database_path, *
+                             [query for query, _, _ in pending_queries], **options)
+            for _, results_key, results_fingerprint in pending_queries:
+                recorded_results[results_key] = results_fingerprint
+
+        fingerprint_path.write_text(json.dumps(fingerprint, indent=2))
+
+    def decode_results(self, database_path: Path, query_path: Path, **options: str) -> List:
+        bqrs_path = self.resolve_bqrs_path(database_path, query_path)
 
         command = ["codeql", "bqrs", "decode"]
         options['format'] = 'csv'
@@ -118,6 +241,16 @@ class CodeQL():
             with open(temp_file) as tmp:
                 return list(csv.reader(tmp))
 
+    def decode_results_in_parallel(self, database_path: Path, queries: List[Tuple[Path, Dict[str, Any]]], max_workers: Optional[int] = None) -> Dict[Path, List]:
+        """
+        Decode the results of each `(query_path, options)` pair concurrently, returning a mapping from query path
+        to the decoded results. Each decode is a separate `codeql bqrs decode` process.
+        """
+        with ThreadPoolExecutor(max_workers=max_workers) as executor:
+            futures = {query_path: executor.submit(
+                self.decode_results, database_path, query_path, **options) for query_path, options in queries}
+            return {query_path: future.result() for query_path, future in futures.items()}
+
     def generate_query_help(self, query_help_path: Path, output: Path, format : str = "markdown", **options: str) -> None:
         command = ['codeql', 'generate', 'query-help']
         options['output'] = str(output)
@@ -0,0 +1,161 @@
+import argparse
+import heapq
+import json
+from pathlib import Path
+import statistics
+import sys
+
+help_statement = """
+Split the CodeQL unit tests of a language into shards of near-equal predicted duration.
+
+The duration of each test directory is predicted from a timing database, which is updated from the JSON reports of
+`codeql test run --format=json`. Test directories without a recorded timing are predicted to take the median
+duration of the recorded directories.
+
+Examples:
+  shard_tests.py shard --language cpp --shard 1 --num-shards 4 --timings test_timings.json
+  shard_tests.py record --timings test_timings.json test_report_*.json
+"""
+
+repository_root = Path(__file__).resolve().parent.parent.parent
+
+# The weight of a new measurement when it is averaged with the recorded duration, to smooth out noisy runners.
+SMOOTHING_FACTOR = 0.5
+
+
+def find_tests(language, root=repository_root):
+    """
+    Return a dict from each test directory of the language, relative to the root, to the tests in that directory. Tests
+    are returned individually, because `codeql test run` also runs the tests in the subdirectories of a directory.
+    """
+    tests = {}
+    for expected_path in sorted(Path(root, language).glob('*/test/**/*.expected')):
+        for suffix in ['.qlref', '.ql']:
+            test_path = expected_path.with_suffix(suffix)
+            if test_path.exists():
+                directory = expected_path.parent.relative_to(root).as_posix()
+                tests.setdefault(directory, []).append(test_path.relative_to(root).as_posix())
+                break
+    return tests
+
+
+def get_test_directory(test_path, root=repository_root):
+    """Return the test directory, relative to the root, of a test path reported by `codeql test run`."""
+    test_path = Path(test_path)
+    try:
+        return test_path.parent.relative_to(root).as_posix()
+    except ValueError:
+        pass
+    # The report may have been produced in a different checkout, so look for the `<language>/<pack>/test` layout
+    parts = test_path.parent.parts
+    for index in range(len(parts) - 2):
+        if parts[index] in ('c', 'cpp') and parts[index + 2] == 'test':
+            return '/'.join(parts[index:])
+    return None
+
+
+def load_timings(timings_path):
+    if timings_path is None or not timings_path.exists():
+        return {}
+    with timings_path.open() as timings_file:
+        return json.load(timings_file)["directories"]
+
+
+def save_timings(timings, timings_path):
+    with timings_path.open('w') as timings_file:
+        json.dump({"directories": dict(sorted(timings.items()))}, timings_file, indent=2)
+        timings_file.write('\n')
+
+
+def record_timings(timings, reports, root=repository_root):
+    """
+    Update the timings, in milliseconds, of each test directory with the compilation and evaluation times of its tests
+    in the given `codeql test run` reports.
+    """
+    measured = {}
+    for report in reports:
+        for result in report:
+            directory = get_test_directory(result["test"], root)
+            if directory is None:
+                continue
+            measured[directory] = measured.get(directory, 0) + result.get("compilationMs", 0) + result.get("evaluationMs", 0)
+
+    updated = dict(timings)
+    for directory, millis in measured.items():
+        if directory in updated:
+            updated[directory] = round(SMOOTHING_FACTOR * millis + (1 - SMOOTHING_FACTOR) * updated[directory])
+        else:
+            updated[directory] = millis
+    return updated
+
+
+def partition(directories, timings, num_shards):
+    """
+    Assign the test directories to `num_shards` shards of near-equal predicted duration, by assigning the directories
+    in decreasing order of duration to the shard with the least predicted duration so far. Returns a list of
+    (predicted duration, directories) for each shard.
+    """
+    known = [timings[directory] for directory in directories if directory in timings]
+    default_millis = statistics.median(known) if known else 1
+
+    # Sort by name as well, so that the shards do not depend on the order in which the directories were found
+    predicted = sorted(((timings.get(directory, default_millis), directory) for directory in directories),
+                       key=lambda entry: (-entry[0], entry[1]))
+
+    shards = [[] for _ in range(num_shards)]
+    heap = [(0, shard) for shard in range(num_shards)]
+    for millis, directory in predicted:
+        total, shard = heapq.heappop(heap)
+        shards[shard].append(directory)
+        heapq.heappush(heap, (total + millis, shard))
+
+    totals = {shard: total for total, shard in heap}
+    return [(totals[shard], sorted(shards[shard])) for shard in range(num_shards)]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog='shard_tests', description=help_statement, formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    shard_parser = subparsers.add_parser('shard', help='Print the tests of a shard, one per line.')
+    shard_parser.add_argument('--language', choices=['c', 'cpp'], required=True,
+                              help='The language of the tests.')
+    shard_parser.add_argument('--shard', type=int, required=True,
+                              help='The 1-based index of the shard.')
+    shard_parser.add_argument('--num-shards', type=int, required=True,
+                              help='The number of shards.')
+    shard_parser.add_argument('--timings', type=Path, required=False,
+                              help='The timing database used to predict the duration of the test directories.')
+
+    record_parser = subparsers.add_parser('record', help='Update the timing database from test reports.')
+    record_parser.add_argument('--timings', type=Path, required=True,
+                               help='The timing database to update, which is created if it does not exist.')
+    record_parser.add_argument('reports', type=Path, nargs='+',
+                               help='The JSON reports of `codeql test run --format=json`.')
+    args = parser.parse_args()
+
+    if args.command == 'shard':
+        if args.num_shards < 1 or not 1 <= args.shard <= args.num_shards:
+            print(f"Invalid shard {args.shard} of {args.num_shards}.", file=sys.stderr)
+            sys.exit(1)
+        tests = find_tests(args.language)
+        shards = partition(list(tests.keys()), load_timings(args.timings), args.num_shards)
+        predicted_millis, directories = shards[args.shard - 1]
+        print(f"Shard {args.shard} of {args.num_shards}: {len(directories)} test directories, predicted duration {predicted_millis / 1000:.0f}s",
+              file=sys.stderr)
+        for directory in directories:
+            for test in tests[directory]:
+                print(test)
+    elif args.command == 'record':
+        reports = []
+        for report_path in args.reports:
+            with report_path.open() as report_file:
+                reports.append(json.load(report_file))
+        timings = record_timings(load_timings(args.timings), reports)
+        save_timings(timings, args.timings)
+        print(f"Recorded the timings of {len(timings)} test directories in {args.timings}.")
+
+
+if __name__ == '__main__':
+    main()
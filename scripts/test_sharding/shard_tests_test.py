@@ -0,0 +1,60 @@
+from shard_tests import find_tests, get_test_directory, load_timings, save_timings, record_timings, partition
+
+
+def test_find_tests(tmp_path):
+    for test_file in ["cpp/autosar/test/rules/A1/A1.qlref", "cpp/autosar/test/rules/A1/A1.expected",
+                      "cpp/autosar/test/rules/A1/nested/B.ql", "cpp/autosar/test/rules/A1/nested/B.expected",
+                      "cpp/autosar/test/rules/A2/test.cpp"]:
+        (tmp_path / test_file).parent.mkdir(parents=True, exist_ok=True)
+        (tmp_path / test_file).touch()
+
+    assert(find_tests("cpp", tmp_path) == {
+        "cpp/autosar/test/rules/A1": ["cpp/autosar/test/rules/A1/A1.qlref"],
+        "cpp/autosar/test/rules/A1/nested": ["cpp/autosar/test/rules/A1/nested/B.ql"]
+    })
+
+
+def test_get_test_directory(tmp_path):
+    assert(get_test_directory(tmp_path / "cpp/cert/test/rules/X/X.qlref", tmp_path) == "cpp/cert/test/rules/X")
+    assert(get_test_directory("/home/runner/work/repo/c/misra/test/rules/R/R.qlref", tmp_path) == "c/misra/test/rules/R")
+
+
+def test_record_timings(tmp_path):
+    report = [
+        {"test": str(tmp_path / "c/misra/test/rules/R/R1.qlref"), "pass": True, "compilationMs": 100, "evaluationMs": 300},
+        {"test": str(tmp_path / "c/misra/test/rules/R/R2.qlref"), "pass": True, "compilationMs": 100, "evaluationMs": 500},
+        {"test": str(tmp_path / "c/misra/test/rules/S/S.qlref"), "pass": False}
+    ]
+    timings = record_timings({"c/misra/test/rules/R": 2000, "c/misra/test/rules/T": 50}, [report], tmp_path)
+    # The new measurement is averaged with the recorded timing
+    assert(timings == {"c/misra/test/rules/R": 1500, "c/misra/test/rules/S": 0, "c/misra/test/rules/T": 50})
+
+
+def test_partition_balances_predicted_duration():
+    timings = {"slow": 100, "a": 40, "b": 30, "c": 30, "d": 20}
+    shards = partition(list(timings.keys()) + ["unknown"], timings, 2)
+    # The unknown directory is predicted to take the median duration of 30
+    assert(sorted(total for total, _ in shards) == [120, 130])
+    assert(sorted(directory for _, directories in shards for directory in directories) == sorted(list(timings.keys()) + ["unknown"]))
+    assert(partition(["b", "a"], {}, 3) == [(1, ["a"]), (1, ["b"]), (0, [])])
+
+
+def test_partition_balances_recorded_timings(tmp_path):
+    timings_path = tmp_path / "test_timings.json"
+    # Without a timing database, the shards have the same number of test directories
+    directories = ["c/misra/test/rules/R", "c/misra/test/rules/S", "c/misra/test/rules/T", "c/misra/test/rules/U"]
+    assert(load_timings(timings_path) == {})
+    assert([len(shard) for _, shard in partition(directories, load_timings(timings_path), 2)] == [2, 2])
+
+    report = [
+        {"test": str(tmp_path / "c/misra/test/rules/R/R.qlref"), "pass": True, "compilationMs": 1000, "evaluationMs": 5000},
+        {"test": str(tmp_path / "c/misra/test/rules/S/S.qlref"), "pass": True, "compilationMs": 500, "evaluationMs": 1500},
+        {"test": str(tmp_path / "c/misra/test/rules/T/T.qlref"), "pass": True, "compilationMs": 500, "evaluationMs": 1500},
+        {"test": str(tmp_path / "c/misra/test/rules/U/U.qlref"), "pass": True, "compilationMs": 500, "evaluationMs": 1500}
+    ]
+    save_timings(record_timings(load_timings(timings_path), [report], tmp_path), timings_path)
+
+    # Once timings are recorded, the slow directory gets a shard of its own
+    shards = partition(directories, load_timings(timings_path), 2)
+    assert(shards == [(6000, ["c/misra/test/rules/R"]),
+                      (6000, ["c/misra/test/rules/S", "c/misra/test/rules/T", "c/misra/test/rules/U"])])